@@ -0,0 +1,95 @@
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
+#include "gzip/gzip_writer.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Measures compression throughput at a few levels and strategies, on text-like input and on input that doesn't compress
+// at all.
+
+namespace {
+
+const std::size_t INPUT_SIZE{ 8 << 20 };
+const unsigned int NUM_ITERATIONS{ 3 };
+
+std::vector<std::byte> make_text(std::mt19937 &generator)
+{
+  // Words drawn from a small vocabulary give roughly the match structure of English text.
+  std::vector<std::string> vocabulary{};
+  for (unsigned int i{ 0 }; i < 2000; i++) {
+    std::string word(1 + generator() % 10, ' ');
+    for (auto &c : word) {
+      c = static_cast<char>('a' + generator() % 26);
+    }
+    vocabulary.push_back(word);
+  }
+
+  std::vector<std::byte> text{};
+  while (text.size() < INPUT_SIZE) {
+    // Squaring skews the distribution towards the start of the vocabulary, like word frequencies are.
+    auto index{ static_cast<std::size_t>(generator() % vocabulary.size()) };
+    for (auto c : vocabulary[index * index / vocabulary.size()]) {
+      text.push_back(static_cast<std::byte>(c));
+    }
+    text.push_back(std::byte{ ' ' });
+  }
+  text.resize(INPUT_SIZE);
+  return text;
+}
+
+std::vector<std::byte> make_random(std::mt19937 &generator)
+{
+  std::vector<std::byte> bytes(INPUT_SIZE);
+  for (auto &byte : bytes) {
+    byte = static_cast<std::byte>(generator());
+  }
+  return bytes;
+}
+
+// Returns the throughput in MB/s and the compressed size.
+std::pair<double, std::size_t> measure(const std::vector<std::byte> &input, const lzss::LzssEncoderConfig &config)
+{
+  std::vector<std::byte> output{};
+
+  auto start{ std::chrono::steady_clock::now() };
+
+  for (unsigned int i{ 0 }; i < NUM_ITERATIONS; i++) {
+    output.clear();
+    bit_io::SpanByteSource source{ input };
+    bit_io::VectorByteSink sink{ output };
+    gzip::GzipWriter{ source, sink, config }.write();
+  }
+
+  std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+  return { NUM_ITERATIONS * input.size() / elapsed.count() / 1e6, output.size() };
+}
+
+}  // namespace
+
+int main()
+{
+  std::mt19937 generator{ 1 };
+
+  for (auto &[name, input] : { std::pair{ "text", make_text(generator) }, std::pair{ "random", make_random(generator) } }) {
+    for (auto level : { lzss::MIN_LEVEL, lzss::DEFAULT_LEVEL }) {
+      auto [throughput, compressed_size]{ measure(input, lzss::get_level_config(level)) };
+      std::cout << name << ", level " << level << ": " << throughput << " MB/s, " << compressed_size << " bytes\n";
+    }
+
+    for (auto [strategy_name, strategy] :
+      { std::pair{ "RLE", lzss::Strategy::RLE }, std::pair{ "Huffman only", lzss::Strategy::HUFFMAN_ONLY } }) {
+      auto config{ lzss::get_level_config(lzss::DEFAULT_LEVEL) };
+      config.strategy = strategy;
+
+      auto [throughput, compressed_size]{ measure(input, config) };
+      std::cout << name << ", " << strategy_name << ": " << throughput << " MB/s, " << compressed_size << " bytes\n";
+    }
+  }
+}
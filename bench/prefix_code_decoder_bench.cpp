@@ -0,0 +1,99 @@
+#include "bit_io/bit_reader.hpp"
+#include "bit_io/bit_writer.hpp"
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
+#include "prefix_codes/decoding_table.hpp"
+#include "prefix_codes/prefix_code_decoder.hpp"
+#include "prefix_codes/prefix_code_encoder.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares single-symbol and multi-literal decoding of literal-only streams with different amounts of skew.
+
+namespace {
+
+const unsigned int NUM_SYMBOLS{ 1 << 24 };
+const unsigned int END_OF_BLOCK{ 256 };
+
+std::vector<unsigned int> generate_symbols(double skew)
+{
+  std::vector<double> weights{};
+  for (unsigned int i{ 0 }; i < 256; i++) {
+    weights.push_back(1.0 / (1.0 + skew * i));
+  }
+
+  std::mt19937 generator{ 1 };
+  std::discrete_distribution<unsigned int> distribution{ weights.begin(), weights.end() };
+
+  std::vector<unsigned int> symbols{};
+  for (unsigned int i{ 0 }; i < NUM_SYMBOLS; i++) {
+    symbols.push_back(distribution(generator));
+  }
+  symbols.push_back(END_OF_BLOCK);
+
+  return symbols;
+}
+
+double measure(const std::vector<std::byte> &stream, const prefix_codes::CodeLengthTable &code_length_table, bool multi)
+{
+  bit_io::SpanByteSource source{ stream };
+  bit_io::BitReader bit_reader{ source };
+  prefix_codes::DecodingTable decoding_table{ code_length_table };
+  prefix_codes::MultiLiteralTable multi_literal_table{ decoding_table };
+  auto decoder{ multi ? prefix_codes::PrefixCodeDecoder{ bit_reader, decoding_table, multi_literal_table }
+                      : prefix_codes::PrefixCodeDecoder{ bit_reader, decoding_table } };
+
+  auto start{ std::chrono::steady_clock::now() };
+
+  prefix_codes::PrefixCodeDecoder::SymbolBuffer symbols{};
+  unsigned int num_decoded{ 0 };
+  while (true) {
+    auto count{ decoder.decode_symbols(symbols) };
+    num_decoded += count;
+    if (count == 1 && symbols[0] == END_OF_BLOCK) {
+      break;
+    }
+  }
+
+  std::chrono::duration<double> elapsed{ std::chrono::steady_clock::now() - start };
+  return num_decoded / elapsed.count() / 1e6;
+}
+
+}  // namespace
+
+int main()
+{
+  for (double skew : { 0.0, 0.5, 5.0, 50.0 }) {
+    auto symbols{ generate_symbols(skew) };
+
+    prefix_codes::FrequencyTable frequencies{};
+    for (auto symbol : symbols) {
+      frequencies[symbol]++;
+    }
+
+    prefix_codes::PrefixCodeEncoder encoder{ 15 };
+    encoder.encode(frequencies);
+    const auto &code_table{ encoder.get_code_table() };
+    const auto &code_length_table{ encoder.get_code_length_table() };
+
+    std::vector<std::byte> stream{};
+    bit_io::VectorByteSink sink{ stream };
+    bit_io::BitWriter bit_writer{ sink };
+    for (auto symbol : symbols) {
+      bit_writer.put_bits(code_table[symbol], code_length_table[symbol], false);
+    }
+    bit_writer.finish();
+
+    auto single{ measure(stream, code_length_table, false) };
+    auto multi{ measure(stream, code_length_table, true) };
+
+    std::cout << "skew " << skew << ": " << 8.0 * stream.size() / symbols.size() << " bits/literal, single-symbol "
+              << single << " M literals/s, multi-literal " << multi << " M literals/s (" << multi / single << "x)\n";
+  }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bit_io {
+
+// Stands in for a `BitWriter` when only the size of the output is wanted. It takes the same calls, but just counts the
+// bits instead of writing them anywhere.
+class BitCounter
+{
+public:
+  // `bit_count` is the position the output starts at, which matters for padding.
+  BitCounter(uint64_t bit_count = 0) : bit_count_{ bit_count } {}
+
+  void put_single_bit(bool) { bit_count_++; }
+  void put_bits(uint64_t, int num_bits, bool = true) { bit_count_ += num_bits; }
+  void pad_to_byte() { bit_count_ += (8 - bit_count_ % 8) % 8; }
+
+  uint64_t get_bit_count() const { return bit_count_; }
+
+private:
+  uint64_t bit_count_;
+};
+
+}  // namespace bit_io
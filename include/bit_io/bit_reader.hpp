@@ -1,24 +1,44 @@
 #pragma once
 
+#include "bit_io/byte_source.hpp"
+
+#include <cstddef>
 #include <cstdint>
 #include <istream>
+#include <memory>
+#include <span>
 
 namespace bit_io {
 
 class BitReader
 {
 public:
+  BitReader(ByteSource &source);
   BitReader(std::istream &input);
 
+  // The most bits that can be looked at in one call to `peek_bits()`.
+  static const int MAX_PEEK_BITS{ 56 };
+
   bool get_single_bit();
   uint64_t get_bits(int num_bits, bool low_bit_first = true);
+  uint64_t peek_bits(int num_bits);
+  void consume_bits(int num_bits);
   void align_to_byte();
   bool eof() const;
 
 private:
-  std::istream &input_;
-  int current_bit_{ 0 };
-  uint8_t current_byte_{ 0 };
+  void refill();
+  bool read_block();
+
+  // Input is read from the source in large blocks, and bits are fed from the block into a 64-bit buffer. Bits past the
+  // end of the input read as zeros; consuming them is what sets EOF.
+  std::unique_ptr<ByteSource> owned_source_{};
+  ByteSource &source_;
+  std::span<const std::byte> block_{};
+  std::size_t block_pos_{ 0 };
+  uint64_t bit_buffer_{ 0 };
+  int bit_count_{ 0 };
+  bool eof_{ false };
 };
 
 }  // namespace bit_io
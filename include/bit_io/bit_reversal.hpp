@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace bit_io {
+
+namespace detail {
+
+  constexpr auto BYTE_REVERSAL_TABLE{ [] {
+    std::array<uint8_t, 256> table{};
+    for (unsigned int byte{ 0 }; byte < table.size(); byte++) {
+      for (unsigned int bit{ 0 }; bit < 8; bit++) {
+        if (byte & (1U << bit)) {
+          table[byte] |= 1U << (7 - bit);
+        }
+      }
+    }
+    return table;
+  }() };
+
+}  // namespace detail
+
+// Reverses the order of the low `num_bits` bits of `value`, where 1 <= `num_bits` <= 64. Higher bits are discarded.
+constexpr uint64_t reverse_bits(uint64_t value, int num_bits)
+{
+  uint64_t reversed{ 0 };
+  for (int i{ 0 }; i < 8; i++) {
+    reversed = (reversed << 8) | detail::BYTE_REVERSAL_TABLE[value & 0xFF];
+    value >>= 8;
+  }
+  return reversed >> (64 - num_bits);
+}
+
+}  // namespace bit_io
@@ -1,24 +1,71 @@
 #pragma once
 
+#include "bit_io/bit_reversal.hpp"
+#include "bit_io/byte_sink.hpp"
+
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <ostream>
+#include <vector>
 
 namespace bit_io {
 
 class BitWriter
 {
 public:
+  BitWriter(ByteSink &sink);
   BitWriter(std::ostream &output);
 
-  void put_single_bit(bool value);
-  void put_bits(uint64_t value, int num_bits, bool low_bit_first = true);
+  void put_single_bit(bool value) { put_bits(value, 1); }
+
+  // Every symbol of a block goes through here, so the common case is kept inline.
+  void put_bits(uint64_t value, int num_bits, bool low_bit_first = true)
+  {
+    assert(num_bits > 0 && num_bits <= 64);
+
+    if (!low_bit_first) {
+      value = reverse_bits(value, num_bits);
+    }
+    if (num_bits < 64) {
+      value &= (uint64_t{ 1 } << num_bits) - 1;
+    }
+
+    bit_buffer_ |= value << bit_count_;
+    bit_count_ += num_bits;
+
+    if (bit_count_ >= 64) {
+      flush_bit_buffer();
+
+      // Carry over the high bits of `value` that didn't fit in the accumulator.
+      bit_count_ -= 64;
+      bit_buffer_ = bit_count_ > 0 ? value >> (num_bits - bit_count_) : 0;
+    }
+  }
+
   void pad_to_byte();
   void finish();
 
+  // The total number of bits written so far, including padding.
+  uint64_t get_bit_count() const { return 8 * (flushed_byte_count_ + byte_count_) + bit_count_; }
+
 private:
-  std::ostream &output_;
-  int current_bit_{ 0 };
-  uint8_t current_byte_{ 0 };
+  void flush_bit_buffer();
+  void flush_whole_bytes();
+  void flush_byte_buffer();
+
+  // Bits are packed into a 64-bit accumulator, which is spilled 8 bytes at a time into a byte buffer. The byte buffer
+  // only goes out to the sink when it fills up or the writer is finished, so `finish()` must be called at the end.
+  static const std::size_t BYTE_BUFFER_SIZE{ 65536 };
+
+  std::unique_ptr<ByteSink> owned_sink_{};
+  ByteSink &sink_;
+  uint64_t bit_buffer_{ 0 };
+  int bit_count_{ 0 };
+  std::vector<std::byte> byte_buffer_;
+  std::size_t byte_count_{ 0 };
+  uint64_t flushed_byte_count_{ 0 };
 };
 
 }  // namespace bit_io
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bit_io {
+
+// Receives output bytes in blocks.
+class ByteSink
+{
+public:
+  virtual ~ByteSink() = default;
+
+  virtual void write(std::span<const std::byte> bytes) = 0;
+};
+
+class StreamByteSink : public ByteSink
+{
+public:
+  StreamByteSink(std::ostream &output) : output_{ output } {}
+
+  void write(std::span<const std::byte> bytes) override;
+
+private:
+  std::ostream &output_;
+};
+
+// Appends to a caller-owned vector, growing it as needed.
+class VectorByteSink : public ByteSink
+{
+public:
+  VectorByteSink(std::vector<std::byte> &output) : output_{ output } {}
+
+  void write(std::span<const std::byte> bytes) override;
+
+private:
+  std::vector<std::byte> &output_;
+};
+
+// Fills a caller-provided buffer. Writing past the end of the buffer throws `ByteSinkError`.
+class SpanByteSink : public ByteSink
+{
+public:
+  SpanByteSink(std::span<std::byte> output) : output_{ output } {}
+
+  void write(std::span<const std::byte> bytes) override;
+
+  auto size() const { return size_; }
+
+private:
+  std::span<std::byte> output_;
+  std::size_t size_{ 0 };
+};
+
+class ByteSinkError : public std::exception
+{
+public:
+  ByteSinkError(const std::string &message) : message_{ message } {}
+
+  const char *what() const noexcept { return message_.c_str(); }
+
+private:
+  const std::string message_;
+};
+
+}  // namespace bit_io
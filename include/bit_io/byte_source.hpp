@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <span>
+#include <vector>
+
+namespace bit_io {
+
+// Supplies input bytes in blocks. Blocks are only empty once the input is exhausted, and a returned block stays valid
+// until the next call to `read_block()`.
+class ByteSource
+{
+public:
+  virtual ~ByteSource() = default;
+
+  virtual std::span<const std::byte> read_block() = 0;
+};
+
+class StreamByteSource : public ByteSource
+{
+public:
+  StreamByteSource(std::istream &input);
+
+  std::span<const std::byte> read_block() override;
+
+private:
+  static const std::size_t BLOCK_SIZE{ 65536 };
+
+  std::istream &input_;
+  std::vector<std::byte> block_;
+};
+
+// Hands out the caller's buffer as a single block, so nothing is copied.
+class SpanByteSource : public ByteSource
+{
+public:
+  SpanByteSource(std::span<const std::byte> input) : input_{ input } {}
+
+  std::span<const std::byte> read_block() override;
+
+private:
+  std::span<const std::byte> input_;
+};
+
+}  // namespace bit_io
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "gzip/emission_table.hpp"
+#include "lzss/lzss_symbol.hpp"
+#include "prefix_codes/prefix_code_encoder.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace gzip {
+
+// Encodes some input as a DEFLATE block of any type. The codes for a dynamic block are worked out up front, so the exact
+// size of each block type can be found before choosing one to write.
+class BlockEncoder
+{
+public:
+  enum class BlockType : unsigned int { STORED = 0, FIXED = 1, DYNAMIC = 2 };
+
+  // The most input a stored block can hold.
+  static constexpr std::size_t MAX_STORED_BLOCK_LENGTH{ 65535 };
+
+  // `input` is the input for the block, and `symbol_buffer` is its LZSS encoding. Both must stay alive while the block
+  // is in use. Blocks that aren't storable are never written as stored blocks, and don't need their input.
+  void prepare(std::string_view input, const lzss::LzssSymbolBuffer &symbol_buffer, bool is_storable = true);
+
+  // The exact size of the block in bits, header included, if it were written starting at bit `bit_position` of the
+  // output. The position only matters for the padding in stored blocks.
+  uint64_t get_block_size(BlockType block_type, uint64_t bit_position = 0) const;
+
+  // The block type that gives the smallest block when written starting at bit `bit_position` of the output.
+  BlockType get_smallest_block_type(uint64_t bit_position = 0) const;
+
+  // `BitSink` is either a `bit_io::BitWriter`, or a `bit_io::BitCounter`, which the tests use to check that
+  // `get_block_size` matches the bits actually written.
+  template <typename BitSink>
+  void write_block(BitSink &bit_sink, BlockType block_type, bool is_last_block) const;
+
+  // Writes `input` as a stored block, which needs no symbols. Used when several stored blocks are merged into one.
+  template <typename BitSink>
+  static void write_stored_block(BitSink &bit_sink, std::string_view input, bool is_last_block);
+
+private:
+  template <typename BitSink>
+  static void write_stored_bytes(BitSink &bit_sink, std::string_view input);
+  template <typename BitSink>
+  void write_dynamic_header(BitSink &bit_sink) const;
+  template <typename BitSink>
+  void write_symbols(BitSink &bit_sink, const EmissionTable &emission_table) const;
+
+  void compute_dynamic_codes();
+  uint64_t get_symbols_size(const prefix_codes::CodeLengthTable &ll_code_lengths,
+    const prefix_codes::CodeLengthTable &distance_code_lengths) const;
+  void run_length_encode_code_lengths();
+
+  static const unsigned int MAX_LL_DISTANCE_CODE_LENGTH{ 15 };
+  static const unsigned int MAX_CL_CODE_LENGTH{ 7 };
+  static const unsigned int MAX_LL_CODE{ 285 };
+  static const unsigned int MAX_DISTANCE_CODE{ 29 };
+  static const unsigned int NUM_CL_CODES{ 19 };
+
+  // The length/literal and distance code lengths are run-length encoded together. Each run is written as one literal
+  // code length, followed by repeats of it: code 16 repeats a nonzero length 3-6 times, and codes 17 and 18 repeat zero
+  // 3-10 and 11-138 times respectively.
+  struct ClSymbol
+  {
+    unsigned int code;
+    unsigned int repeat_count{ 0 };
+  };
+
+  std::string_view input_{};
+  bool is_storable_{ true };
+  const lzss::LzssSymbolBuffer *symbol_buffer_{ nullptr };
+
+  // Block sizes are worked out from the code frequencies, without going through the symbols again.
+  prefix_codes::FrequencyTable ll_freqs_{};
+  prefix_codes::FrequencyTable distance_freqs_{};
+  uint64_t dynamic_header_size_{ 0 };
+
+  prefix_codes::PrefixCodeEncoder ll_encoder_{ MAX_LL_DISTANCE_CODE_LENGTH };
+  prefix_codes::PrefixCodeEncoder distance_encoder_{ MAX_LL_DISTANCE_CODE_LENGTH };
+  prefix_codes::PrefixCodeEncoder cl_encoder_{ MAX_CL_CODE_LENGTH };
+  EmissionTable emission_table_{};
+
+  unsigned int num_ll_codes_{ 0 };
+  unsigned int num_distance_codes_{ 0 };
+  unsigned int num_cl_codes_{ 0 };
+  std::array<ClSymbol, MAX_LL_CODE + 1 + MAX_DISTANCE_CODE + 1> rle_output_{};
+  unsigned int rle_output_size_{ 0 };
+  std::array<unsigned int, NUM_CL_CODES> cl_code_length_buffer_{};
+  std::array<uint64_t, NUM_CL_CODES> reversed_cl_codes_{};
+};
+
+}  // namespace gzip
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "prefix_codes/decoding_table.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace gzip {
+
+// Keeps the decoding tables for the last few distinct length/literal and distance code headers, so that runs of blocks
+// sharing a header only pay for building the tables once.
+class DecodingTableCache
+{
+public:
+  struct Tables
+  {
+    prefix_codes::DecodingTable ll_table;
+    prefix_codes::MultiLiteralTable ll_multi_literal_table;
+    prefix_codes::DecodingTable distance_table;
+  };
+
+  DecodingTableCache();
+
+  // The returned tables stay valid until the next call.
+  const Tables &get_tables(const prefix_codes::CodeLengthTable &ll_code_lengths,
+    const prefix_codes::CodeLengthTable &distance_code_lengths);
+
+  auto get_hits() const { return hits_; }
+  auto get_misses() const { return misses_; }
+
+private:
+  static const unsigned int NUM_ENTRIES{ 4 };
+
+  // Entries are looked up by a hash of the code lengths first, and only compared in full when the hashes match.
+  struct Entry
+  {
+    bool valid{ false };
+    uint64_t hash{ 0 };
+    uint64_t last_used{ 0 };
+    prefix_codes::CodeLengthTable ll_code_lengths{};
+    prefix_codes::CodeLengthTable distance_code_lengths{};
+    Tables tables{};
+  };
+
+  static uint64_t hash_code_lengths(const prefix_codes::CodeLengthTable &ll_code_lengths,
+    const prefix_codes::CodeLengthTable &distance_code_lengths);
+
+  std::vector<Entry> entries_;
+  uint64_t num_lookups_{ 0 };
+  uint64_t hits_{ 0 };
+  uint64_t misses_{ 0 };
+};
+
+}  // namespace gzip
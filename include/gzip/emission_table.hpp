@@ -0,0 +1,92 @@
+#pragma once
+
+#include "bit_io/bit_reversal.hpp"
+#include "lzss/lzss_code_tables.hpp"
+#include "prefix_codes/canonical_codes.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace gzip {
+
+// Holds the prefix codes for a block in the form they are written in: bit-reversed, so that they can go straight into
+// the bit writer low bit first. Match lengths map directly to their length code followed by its extra bits.
+class EmissionTable
+{
+public:
+  struct Entry
+  {
+    uint32_t bits;
+    uint32_t num_bits;
+  };
+
+  constexpr EmissionTable() = default;
+  constexpr EmissionTable(const prefix_codes::CodeLengthTable &ll_code_lengths,
+    const prefix_codes::CodeLengthTable &distance_code_lengths)
+  {
+    initialize(ll_code_lengths, distance_code_lengths);
+  }
+
+  constexpr void initialize(const prefix_codes::CodeLengthTable &ll_code_lengths,
+    const prefix_codes::CodeLengthTable &distance_code_lengths);
+
+  constexpr const auto &get_ll_entry(unsigned int code) const
+  {
+    assert(code < ll_table_.size() && "searching for invalid length/literal code in emission table");
+    return ll_table_[code];
+  }
+  constexpr const auto &get_length_entry(unsigned int length) const
+  {
+    assert(length >= MIN_LENGTH && length <= MAX_LENGTH && "searching for invalid length in emission table");
+    return length_table_[length - MIN_LENGTH];
+  }
+  constexpr const auto &get_distance_entry(unsigned int code) const
+  {
+    assert(code < distance_table_.size() && "searching for invalid distance code in emission table");
+    return distance_table_[code];
+  }
+
+private:
+  static const unsigned int MIN_LENGTH{ 3 };
+  static const unsigned int MAX_LENGTH{ 258 };
+  static const unsigned int NUM_DISTANCE_CODES{ 32 };
+
+  static constexpr void fill_reversed_codes(const prefix_codes::CodeLengthTable &code_lengths, auto &table)
+  {
+    auto codes{ prefix_codes::compute_canonical_code_table(code_lengths) };
+
+    for (unsigned int code{ 0 }; code < table.size(); code++) {
+      auto length{ code_lengths[code] };
+      if (length == 0) {
+        table[code] = {};
+        continue;
+      }
+      table[code] = { static_cast<uint32_t>(bit_io::reverse_bits(codes[code], length)), length };
+    }
+  }
+
+  std::array<Entry, prefix_codes::MAX_NUM_SYMBOLS> ll_table_{};
+  std::array<Entry, MAX_LENGTH - MIN_LENGTH + 1> length_table_{};
+  std::array<Entry, NUM_DISTANCE_CODES> distance_table_{};
+};
+
+constexpr void EmissionTable::initialize(const prefix_codes::CodeLengthTable &ll_code_lengths,
+  const prefix_codes::CodeLengthTable &distance_code_lengths)
+{
+  fill_reversed_codes(ll_code_lengths, ll_table_);
+  fill_reversed_codes(distance_code_lengths, distance_table_);
+
+  // The extra bits of a length hold its offset from the start of the code's range, and come right after the code.
+  for (auto length{ MIN_LENGTH }; length <= MAX_LENGTH; length++) {
+    const auto &length_entry{ lzss::code_tables::get_length_entry_by_length(length) };
+    const auto &code_entry{ ll_table_[length_entry.code] };
+
+    auto offset{ length - length_entry.lower_bound };
+    length_table_[length - MIN_LENGTH] = { code_entry.bits | (offset << code_entry.num_bits),
+      code_entry.num_bits + length_entry.extra_bits };
+  }
+}
+
+}  // namespace gzip
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "gzip/emission_table.hpp"
+#include "prefix_codes/decoding_table.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+// The fixed prefix codes used by block type 1, from RFC 1951, section 3.2.6. Everything here is built at compile time
+// and shared by all readers and writers.
+namespace gzip::fixed_code_tables {
+
+inline constexpr auto LL_CODE_LENGTHS{ [] {
+  prefix_codes::CodeLengthTable code_lengths{};
+  for (unsigned int code{ 0 }; code <= 143; code++) {
+    code_lengths[code] = 8;
+  }
+  for (unsigned int code{ 144 }; code <= 255; code++) {
+    code_lengths[code] = 9;
+  }
+  for (unsigned int code{ 256 }; code <= 279; code++) {
+    code_lengths[code] = 7;
+  }
+  for (unsigned int code{ 280 }; code <= 287; code++) {
+    code_lengths[code] = 8;
+  }
+  return code_lengths;
+}() };
+
+// Distance codes 30 and 31 never occur in the data, but they are still part of the code.
+inline constexpr auto DISTANCE_CODE_LENGTHS{ [] {
+  prefix_codes::CodeLengthTable code_lengths{};
+  for (unsigned int code{ 0 }; code <= 31; code++) {
+    code_lengths[code] = 5;
+  }
+  return code_lengths;
+}() };
+
+inline constexpr EmissionTable EMISSION_TABLE{ LL_CODE_LENGTHS, DISTANCE_CODE_LENGTHS };
+
+inline constexpr prefix_codes::DecodingTable LL_DECODING_TABLE{ LL_CODE_LENGTHS };
+inline constexpr prefix_codes::DecodingTable DISTANCE_DECODING_TABLE{ DISTANCE_CODE_LENGTHS };
+
+}  // namespace gzip::fixed_code_tables
@@ -1,26 +1,39 @@
 #pragma once
 
 #include "bit_io/bit_reader.hpp"
-#include "prefix_codes/prefix_code_decoder.hpp"
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
+#include "gzip/decoding_table_cache.hpp"
+#include "gzip/stream_format.hpp"
+#include "prefix_codes/decoding_table.hpp"
 #include "prefix_codes/prefix_code_types.hpp"
 
-#include <deque>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
-#include <istream>
-#include <ostream>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace gzip {
 
+// Reads gzip streams, and zlib and raw DEFLATE streams like those `GzipWriter` can write. A stream written with a preset
+// dictionary needs the same dictionary to be read.
 class GzipReader
 {
 public:
-  GzipReader(std::istream &input, std::ostream &output);
+  GzipReader(bit_io::ByteSource &input,
+    bit_io::ByteSink &output,
+    StreamFormat format = StreamFormat::GZIP,
+    std::span<const std::byte> dictionary = {});
 
   void read();
 
+  const auto &get_decoding_table_cache() const { return decoding_table_cache_; }
+
 private:
   void read_header();
+  void read_zlib_header();
   void read_deflate_bit_stream();
   void read_footer();
 
@@ -28,19 +41,32 @@ private:
   void read_block_type_1();
   void read_block_type_2();
 
-  // XXX: All this stuff should go elsewhere.
-  void compute_fixed_code_tables();
-  prefix_codes::CodeLengthTable fixed_ll_code_lengths_{};
-  prefix_codes::CodeLengthTable fixed_distance_code_lengths_{};
-  prefix_codes::PrefixCodeDecoder fixed_ll_code_decoder_{ bit_reader_, fixed_ll_code_lengths_ };
-  prefix_codes::PrefixCodeDecoder fixed_distance_code_decoder_{ bit_reader_, fixed_distance_code_lengths_ };
-
-  std::istream &input_;
-  std::ostream &output_;
   bit_io::BitReader bit_reader_;
+  bit_io::ByteSink &output_;
+  const StreamFormat format_;
+  std::span<const std::byte> dictionary_;
+
+  // Dynamic blocks often repeat the code lengths of the block before, in which case the tables built for it are reused.
+  // The CL table is cheap to build, so only the last one is kept.
+  prefix_codes::CodeLengthTable cl_code_lengths_{};
+  prefix_codes::DecodingTable cl_decoding_table_{};
+  DecodingTableCache decoding_table_cache_{};
 
   // XXX: This should be managed by an LZSS decoder class.
-  std::deque<unsigned int> history_{};
+  void put_literal(unsigned int value);
+  void put_back_reference(unsigned int length, unsigned int distance);
+  void flush_window();
+  void put_dictionary();
+
+  // Decoded bytes go into a window that doubles as the back-reference history. When the window fills up, everything not
+  // yet written goes to the output, and the last `HISTORY_SIZE` bytes are moved to the front.
+  static constexpr std::size_t HISTORY_SIZE{ 32768 };
+  static constexpr std::size_t WINDOW_SIZE{ 4 * HISTORY_SIZE };
+  std::vector<std::byte> window_;
+  std::size_t window_pos_{ 0 };
+  std::size_t flushed_pos_{ 0 };
+  uint64_t output_size_{ 0 };
+  std::size_t dictionary_size_{ 0 };
 };
 
 class GzipReaderError : public std::exception
@@ -1,42 +1,70 @@
 #pragma once
 
 #include "bit_io/bit_writer.hpp"
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
+#include "gzip/block_encoder.hpp"
+#include "gzip/stream_format.hpp"
 #include "lzss/lzss_encoder.hpp"
-#include "prefix_codes/fixed_code_table.hpp"
+#include "lzss/lzss_encoder_config.hpp"
 
-#include <istream>
-#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 
 namespace gzip {
 
+// Despite the name, this can also write zlib and raw DEFLATE streams, which is the only way to use a preset dictionary.
+// The dictionary's bytes are never written. The reader has to be given the same ones.
 class GzipWriter
 {
 public:
-  GzipWriter(std::istream &input, std::ostream &output);
+  GzipWriter(bit_io::ByteSource &input,
+    bit_io::ByteSink &output,
+    const lzss::LzssEncoderConfig &config = lzss::get_level_config(lzss::DEFAULT_LEVEL),
+    StreamFormat format = StreamFormat::GZIP,
+    std::span<const std::byte> dictionary = {});
 
   void write();
 
 private:
   void write_header();
+  void write_zlib_header();
   void write_deflate_bit_stream();
+  void write_block(bool is_last_block);
   void write_footer();
+  void put_big_endian(uint32_t value);
 
-  // XXX: Put this stuff in a separate deflate writer class?
   static const unsigned int INPUT_CHUNK_SIZE{ 65535 };
-  std::string read_input_chunk();
-  void write_block_type_0(std::string_view input_buffer, bool is_last_block);
-  void write_block_type_1(std::string_view input_buffer, bool is_last_block);
-  void write_block_type_2(std::string_view input_buffer, bool is_last_block);
+  std::string_view read_input_chunk();
+  bool at_end_of_input();
+
+  const StreamFormat format_;
+  // The FLEVEL field of a zlib header, which says roughly how hard the encoder tried.
+  const unsigned int zlib_level_;
+  std::span<const std::byte> dictionary_;
 
   unsigned int input_size_{ 0 };
-  std::istream &input_;
-  std::ostream &output_;
+  uint32_t input_adler32_{ 1 };
+  bit_io::ByteSource &input_;
   bit_io::BitWriter bit_writer_;
 
-  prefix_codes::FixedCodeTable fixed_code_table_{};
-  lzss::LzssEncoder lzss_encoder_{};
+  // Chunks are handed out straight from the source's blocks when possible, and assembled in `input_chunk_` otherwise.
+  std::span<const std::byte> input_block_{};
+  std::string input_chunk_{};
+
+  // A block can span several chunks, so its input is kept here until it is written, for if it is a stored block. Once
+  // the block is too long to store, its input is dropped.
+  std::string block_input_{};
+  bool is_block_storable_{ true };
+
+  // Stored blocks are held back here, so that a run of them can be written as a few full ones.
+  std::string stored_input_{};
+
+  lzss::LzssEncoder lzss_encoder_;
+  BlockEncoder block_encoder_{};
 };
 
 }  // namespace gzip
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace gzip {
+
+// The container around the DEFLATE stream. A preset dictionary can only be used with zlib or raw DEFLATE streams, since
+// gzip has no way of saying that one was used.
+enum class StreamFormat { GZIP, ZLIB, RAW };
+
+// The Adler-32 checksum used by zlib streams, both for the data and to identify a preset dictionary. `adler` is the
+// checksum of any data before `bytes`.
+inline uint32_t update_adler32(uint32_t adler, std::span<const std::byte> bytes)
+{
+  const uint32_t MODULUS{ 65521 };
+  // The most bytes that can be summed before `b` could overflow.
+  const std::size_t MAX_RUN_LENGTH{ 5552 };
+
+  uint32_t a{ adler & 0xffff };
+  uint32_t b{ adler >> 16 };
+
+  while (!bytes.empty()) {
+    auto run{ bytes.first(std::min(bytes.size(), MAX_RUN_LENGTH)) };
+    for (auto byte : run) {
+      a += static_cast<uint32_t>(byte);
+      b += a;
+    }
+    a %= MODULUS;
+    b %= MODULUS;
+    bytes = bytes.subspan(run.size());
+  }
+
+  return (b << 16) | a;
+}
+
+inline uint32_t adler32(std::span<const std::byte> bytes)
+{
+  return update_adler32(1, bytes);
+}
+
+}  // namespace gzip
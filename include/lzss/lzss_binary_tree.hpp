@@ -0,0 +1,81 @@
+#pragma once
+
+#include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+#include "lzss/lzss_window.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace lzss {
+
+// Finds earlier occurrences of strings in the input, LZMA style, with the same interface as `LzssStringTable`. The
+// positions starting with each three-byte hash form a binary search tree, ordered by the strings at them, with the
+// newest position at the root. Inserting a position walks down from the root towards where its string belongs,
+// passing the closest matches on the way, and splits the tree around it.
+//
+// Since searching at a position and inserting it are the same walk, searching at a position also inserts it, and
+// each position can only be searched once.
+class LzssBinaryTree
+{
+public:
+  LzssBinaryTree(const LzssEncoderConfig &config = get_level_config(DEFAULT_LEVEL));
+
+  std::size_t append(std::string_view input, uint64_t position) { return window_.append(input, position); }
+  uint64_t get_end_position() const { return window_.get_end_position(); }
+  char get_byte(uint64_t position) const { return window_.get_byte(position); }
+
+  // Adds every position before `position` to the trees, except for the last couple in the window, which have to wait
+  // for more input to be hashed.
+  void insert_up_to(uint64_t position);
+
+  // Leaves every position before `position` that isn't inserted yet out of the trees.
+  void skip_to(uint64_t position);
+
+  // Looks for the longest earlier string matching the one at `position`, longer than `min_length` and no longer than
+  // `max_length`. The search follows the limits in the config, and stops early at a match of the nice length. Of
+  // equally long matches, the closest one wins. Every position before `position` must already be inserted, and
+  // `position` must not be.
+  std::optional<BackReference> get_back_reference(uint64_t position,
+    unsigned int max_length,
+    unsigned int min_length = constants::MIN_BACKREF_LENGTH - 1);
+
+  // Appends each match found at `position` that is longer than the ones before it to `back_refs`, so a match of any
+  // length up to the longest can be made from the closest back-reference at least that long.
+  void find_back_references(uint64_t position, unsigned int max_length, std::vector<BackReference> &back_refs);
+
+private:
+  static constexpr unsigned int HALF_WINDOW_SIZE{ LzssWindow::HALF_WINDOW_SIZE };
+  static constexpr unsigned int HASH_BITS{ 15 };
+  static constexpr unsigned int HASH_SIZE{ 1U << HASH_BITS };
+  static constexpr unsigned int HASH_SHIFT{ 5 };
+  static constexpr uint64_t NO_POSITION{ UINT64_MAX };
+
+  unsigned int hash_at(uint64_t position) const;
+
+  // Inserts `position`, calling `handle_match` for each match passed on the way that is longer than all earlier ones.
+  // Strings are only compared up to `max_length` bytes, and the walk goes at most `max_depth` nodes deep.
+  template<typename MatchHandler>
+  void insert(uint64_t position,
+    unsigned int max_length,
+    unsigned int min_length,
+    unsigned int max_depth,
+    MatchHandler handle_match);
+
+  LzssWindow window_{};
+
+  // `head_` holds the root of the tree for each hash, and `children_` the smaller and larger child of each position in
+  // the last `HALF_WINDOW_SIZE` bytes, one after the other.
+  std::vector<uint64_t> head_;
+  std::vector<uint64_t> children_;
+  uint64_t next_insert_position_{ 0 };
+
+  const unsigned int max_depth_;
+  const unsigned int nice_length_;
+  const unsigned int good_length_;
+};
+
+}  // namespace lzss
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace lzss {
+
+// Decides where a block should end, by watching how the mix of symbols changes, as in libdeflate. Symbols are sorted
+// into a few rough types, and every so often the types seen since the last check are compared with those seen in the
+// block before them. If they differ by enough, the data has changed character and is better off with new codes.
+//
+// The types are worked out from the block's length/literal code frequencies at each check, so adding a symbol costs
+// next to nothing.
+class LzssBlockSplitter
+{
+public:
+  // Called after each symbol is added to the block, with the frequencies and number of symbols so far.
+  void update(const prefix_codes::FrequencyTable &ll_frequencies, std::size_t num_symbols)
+  {
+    if (num_symbols >= next_check_ && !should_end_block_) {
+      check_for_block_end(ll_frequencies, num_symbols);
+      next_check_ = num_symbols + NUM_SYMBOLS_PER_CHECK;
+    }
+  }
+
+  bool should_end_block() const { return should_end_block_; }
+
+  void clear()
+  {
+    observations_.fill(0);
+    num_observations_ = 0;
+    next_check_ = MIN_BLOCK_SYMBOLS;
+    should_end_block_ = false;
+  }
+
+private:
+  static const unsigned int NUM_LITERAL_TYPES{ 8 };
+  static const unsigned int NUM_TYPES{ NUM_LITERAL_TYPES + 2 };
+  static const std::size_t NUM_SYMBOLS_PER_CHECK{ 512 };
+  // Shorter blocks don't make up for the cost of their headers.
+  static const std::size_t MIN_BLOCK_SYMBOLS{ 4096 };
+
+  void check_for_block_end(const prefix_codes::FrequencyTable &ll_frequencies, std::size_t num_symbols)
+  {
+    // The top bits of a literal separate text from control characters and high bytes, and the bottom bit adds a little
+    // detail. Back-references are split into short and long ones, at length 9, which is where code 263 starts.
+    std::array<std::size_t, NUM_TYPES> new_observations{};
+    for (unsigned int literal{ 0 }; literal < 256; literal++) {
+      new_observations[((literal >> 5) & 0x6) | (literal & 1)] += ll_frequencies[literal];
+    }
+    for (unsigned int code{ 257 }; code <= 285; code++) {
+      new_observations[NUM_LITERAL_TYPES + (code >= 263 ? 1 : 0)] += ll_frequencies[code];
+    }
+    for (unsigned int type{ 0 }; type < NUM_TYPES; type++) {
+      new_observations[type] -= observations_[type];
+    }
+    auto num_new_observations{ num_symbols - num_observations_ };
+
+    // Compare the two distributions, with both scaled up to the same total so that no division is needed.
+    if (num_observations_ > 0) {
+      uint64_t total_difference{ 0 };
+      for (unsigned int type{ 0 }; type < NUM_TYPES; type++) {
+        auto expected{ uint64_t{ observations_[type] } * num_new_observations };
+        auto actual{ uint64_t{ new_observations[type] } * num_observations_ };
+        total_difference += actual > expected ? actual - expected : expected - actual;
+      }
+
+      if (total_difference >= uint64_t{ num_new_observations } * 200 / 512 * num_observations_) {
+        should_end_block_ = true;
+        return;
+      }
+    }
+
+    for (unsigned int type{ 0 }; type < NUM_TYPES; type++) {
+      observations_[type] += new_observations[type];
+    }
+    num_observations_ = num_symbols;
+  }
+
+  std::array<std::size_t, NUM_TYPES> observations_{};
+  std::size_t num_observations_{ 0 };
+  std::size_t next_check_{ MIN_BLOCK_SYMBOLS };
+  bool should_end_block_{ false };
+};
+
+}  // namespace lzss
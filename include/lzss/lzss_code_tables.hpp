@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cassert>
+
 namespace lzss::code_tables {
 
 struct Entry
@@ -10,9 +13,129 @@ struct Entry
   unsigned int upper_bound;
 };
 
-const Entry &get_length_entry_by_code(unsigned int code);
-const Entry &get_distance_entry_by_code(unsigned int code);
-const Entry &get_length_entry_by_length(unsigned int length);
-const Entry &get_distance_entry_by_distance(unsigned int distance);
+namespace detail {
+
+  inline constexpr std::array LENGTH_CODE_TABLE{
+    Entry{ 257, 0, 3, 3 },
+    Entry{ 258, 0, 4, 4 },
+    Entry{ 259, 0, 5, 5 },
+    Entry{ 260, 0, 6, 6 },
+    Entry{ 261, 0, 7, 7 },
+    Entry{ 262, 0, 8, 8 },
+    Entry{ 263, 0, 9, 9 },
+    Entry{ 264, 0, 10, 10 },
+    Entry{ 265, 1, 11, 12 },
+    Entry{ 266, 1, 13, 14 },
+    Entry{ 267, 1, 15, 16 },
+    Entry{ 268, 1, 17, 18 },
+    Entry{ 269, 2, 19, 22 },
+    Entry{ 270, 2, 23, 26 },
+    Entry{ 271, 2, 27, 30 },
+    Entry{ 272, 2, 31, 34 },
+    Entry{ 273, 3, 35, 42 },
+    Entry{ 274, 3, 43, 50 },
+    Entry{ 275, 3, 51, 58 },
+    Entry{ 276, 3, 59, 66 },
+    Entry{ 277, 4, 67, 82 },
+    Entry{ 278, 4, 83, 98 },
+    Entry{ 279, 4, 99, 114 },
+    Entry{ 280, 4, 115, 130 },
+    Entry{ 281, 5, 131, 162 },
+    Entry{ 282, 5, 163, 194 },
+    Entry{ 283, 5, 195, 226 },
+    Entry{ 284, 5, 227, 257 },
+    Entry{ 285, 0, 258, 258 },
+  };
+
+  inline constexpr std::array DISTANCE_CODE_TABLE{
+    Entry{ 0, 0, 1, 1 },
+    Entry{ 1, 0, 2, 2 },
+    Entry{ 2, 0, 3, 3 },
+    Entry{ 3, 0, 4, 4 },
+    Entry{ 4, 1, 5, 6 },
+    Entry{ 5, 1, 7, 8 },
+    Entry{ 6, 2, 9, 12 },
+    Entry{ 7, 2, 13, 16 },
+    Entry{ 8, 3, 17, 24 },
+    Entry{ 9, 3, 25, 32 },
+    Entry{ 10, 4, 33, 48 },
+    Entry{ 11, 4, 49, 64 },
+    Entry{ 12, 5, 65, 96 },
+    Entry{ 13, 5, 97, 128 },
+    Entry{ 14, 6, 129, 192 },
+    Entry{ 15, 6, 193, 256 },
+    Entry{ 16, 7, 257, 384 },
+    Entry{ 17, 7, 385, 512 },
+    Entry{ 18, 8, 513, 768 },
+    Entry{ 19, 8, 769, 1024 },
+    Entry{ 20, 9, 1025, 1536 },
+    Entry{ 21, 9, 1537, 2048 },
+    Entry{ 22, 10, 2049, 3072 },
+    Entry{ 23, 10, 3073, 4096 },
+    Entry{ 24, 11, 4097, 6144 },
+    Entry{ 25, 11, 6145, 8192 },
+    Entry{ 26, 12, 8193, 12288 },
+    Entry{ 27, 12, 12289, 16384 },
+    Entry{ 28, 13, 16385, 24576 },
+    Entry{ 29, 13, 24577, 32768 },
+  };
+
+  // Direct lookup tables, mapping each length and distance to the index of its entry in the tables above.
+  //
+  // The length table is indexed by the length itself. Distances are split into two ranges, like zlib's `_dist_code`:
+  // distances up to 256 are indexed by `distance - 1`, and larger ones by `256 + ((distance - 1) >> 7)`. That works
+  // because every code for a distance above 256 covers a whole number of 128-distance steps.
+  inline constexpr auto LENGTH_INDEX_TABLE{ [] {
+    std::array<unsigned char, LENGTH_CODE_TABLE.back().upper_bound + 1> table{};
+    for (unsigned char i{ 0 }; i < LENGTH_CODE_TABLE.size(); i++) {
+      for (auto length{ LENGTH_CODE_TABLE[i].lower_bound }; length <= LENGTH_CODE_TABLE[i].upper_bound; length++) {
+        table[length] = i;
+      }
+    }
+    return table;
+  }() };
+
+  inline constexpr auto DISTANCE_INDEX_TABLE{ [] {
+    std::array<unsigned char, 512> table{};
+    for (unsigned char i{ 0 }; i < DISTANCE_CODE_TABLE.size(); i++) {
+      for (auto distance{ DISTANCE_CODE_TABLE[i].lower_bound }; distance <= DISTANCE_CODE_TABLE[i].upper_bound;
+           distance++) {
+        table[distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7)] = i;
+      }
+    }
+    return table;
+  }() };
+
+}  // namespace detail
+
+// The codes passed to these come from the compressed data, and are only asserted on here, so callers must reject codes
+// outside the tables first, as `GzipReader` does.
+constexpr const Entry &get_length_entry_by_code(unsigned int code)
+{
+  assert(code >= detail::LENGTH_CODE_TABLE.front().code && code <= detail::LENGTH_CODE_TABLE.back().code
+         && "searching for invalid code in length/literal code table");
+  return detail::LENGTH_CODE_TABLE[code - detail::LENGTH_CODE_TABLE.front().code];
+}
+
+constexpr const Entry &get_distance_entry_by_code(unsigned int code)
+{
+  assert(code < detail::DISTANCE_CODE_TABLE.size() && "searching for invalid code in distance code table");
+  return detail::DISTANCE_CODE_TABLE[code];
+}
+
+constexpr const Entry &get_length_entry_by_length(unsigned int length)
+{
+  assert(length >= detail::LENGTH_CODE_TABLE.front().lower_bound && length < detail::LENGTH_INDEX_TABLE.size()
+         && "searching for invalid length in length/literal code table");
+  return detail::LENGTH_CODE_TABLE[detail::LENGTH_INDEX_TABLE[length]];
+}
+
+constexpr const Entry &get_distance_entry_by_distance(unsigned int distance)
+{
+  assert(distance >= 1 && distance <= detail::DISTANCE_CODE_TABLE.back().upper_bound
+         && "searching for invalid distance in distance code table");
+  auto index{ distance <= 256 ? distance - 1 : 256 + ((distance - 1) >> 7) };
+  return detail::DISTANCE_CODE_TABLE[detail::DISTANCE_INDEX_TABLE[index]];
+}
 
 }  // namespace lzss::code_tables
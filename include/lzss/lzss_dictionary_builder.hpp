@@ -0,0 +1,16 @@
+#pragma once
+
+#include "lzss/lzss_window.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace lzss {
+
+// Builds a preset dictionary of at most `max_size` bytes out of strings that are common across `samples`, which should
+// look like the inputs the dictionary is for. The most useful strings go at the end, where they are closest to the
+// input and so cheapest to refer back to.
+std::string build_dictionary(std::span<const std::string> samples, std::size_t max_size = LzssWindow::MAX_DISTANCE);
+
+}  // namespace lzss
@@ -1,27 +1,85 @@
 #pragma once
 
+#include "lzss/lzss_binary_tree.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+#include "lzss/lzss_hash_table.hpp"
+#include "lzss/lzss_optimal_parser.hpp"
 #include "lzss/lzss_string_table.hpp"
 #include "lzss/lzss_symbol.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string_view>
+#include <variant>
+#include <vector>
 
 namespace lzss {
 
 class LzssEncoder
 {
 public:
-  void encode(std::string_view input_buffer);
+  LzssEncoder(const LzssEncoderConfig &config = get_level_config(DEFAULT_LEVEL));
 
-  const auto &get_symbol_list() const { return symbol_list_; }
-  const auto &get_string_table() const { return string_table_; }
+  // Primes the window and match finder with `dictionary`, as if it had been encoded already, so the input can refer
+  // back into it. Only the last `LzssWindow::MAX_DISTANCE` bytes are used. Must be called before anything is encoded.
+  void set_dictionary(std::string_view dictionary);
+
+  // Encodes `input_buffer` until the symbol buffer says the block should end, and returns the number of bytes encoded.
+  // Any input left over must be passed again, at the start of the next call. The symbol buffer is cleared first, unless
+  // `start_new_block` is false, in which case the symbols are added to the block already in it, which mustn't have
+  // ended.
+  std::size_t encode(std::string_view input_buffer, bool start_new_block = true);
+
+  const auto &get_symbol_buffer() const { return symbol_buffer_; }
 
 private:
+  // Empty for the strategies that don't search for matches, which then don't pay for a window or hash chains.
+  using MatchFinder = std::variant<std::monostate, LzssStringTable, LzssBinaryTree, LzssHashTable>;
+  static MatchFinder make_match_finder(const LzssEncoderConfig &config);
+
+  // These don't search for matches at all.
+  void encode_runs(std::string_view input_buffer);
+  void encode_literals(std::string_view input_buffer);
+
+  // These work the same with either match finder.
+  void encode_fastest(LzssHashTable &hash_table, std::string_view input_buffer);
+  template<typename Finder> void encode_lazy(Finder &match_finder, std::string_view input_buffer);
+  template<typename Finder> void encode_optimal(Finder &match_finder, std::string_view input_buffer);
+  template<typename Finder> void skip_buffered_input(const Finder &match_finder, std::string_view &input_buffer) const;
+  template<typename Finder> void fill_window(Finder &match_finder, std::string_view &input_buffer);
+  template<typename Finder> void insert_back_reference(Finder &match_finder, unsigned int length);
+  unsigned int get_max_length(uint64_t position, uint64_t end_position) const;
+
   void output_back_reference(unsigned int length, unsigned int distance);
   void output_literal(unsigned int value);
 
-  unsigned int current_position_{ 0 };
-  LzssStringTable string_table_{};
-  LzssSymbolList symbol_list_{};
+  uint64_t current_position_{ 0 };
+  MatchFinder match_finder_;
+  LzssSymbolBuffer symbol_buffer_{};
+
+  // A match found by looking ahead one position, which becomes the match at the current position once the literal
+  // before it is written. It is kept between calls, since the position it was found at can't be searched again.
+  std::optional<BackReference> next_back_ref_{};
+
+  // The last byte encoded, or taken from the dictionary, for run-length encoding. A run can then carry on from one call
+  // to the next, and from the dictionary into the input.
+  std::optional<unsigned char> previous_byte_{};
+
+  const Strategy strategy_;
+  const unsigned int max_lazy_length_;
+  const unsigned int max_insert_length_;
+
+  // Only used for optimal parsing. `back_refs_` holds every back-reference found in the input, and `back_ref_offsets_`
+  // where those for each position start.
+  const bool optimal_parse_;
+  LzssOptimalParser optimal_parser_;
+  std::vector<BackReference> back_refs_{};
+  std::vector<std::size_t> back_ref_offsets_{};
+
+  // The part of the last parse that didn't fit in the symbol buffer.
+  std::span<const LzssOptimalParser::Step> remaining_steps_{};
 };
 
 }  // namespace lzss
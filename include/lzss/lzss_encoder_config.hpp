@@ -0,0 +1,74 @@
+#pragma once
+
+#include "lzss/lzss_constants.hpp"
+
+#include <array>
+#include <stdexcept>
+
+namespace lzss {
+
+enum class MatchFinderType { HASH_TABLE, HASH_CHAIN, BINARY_TREE };
+
+// Like zlib's strategies, for input the usual search does badly on. `RLE` only looks for runs of the same byte, as
+// matches at distance 1, which suits data that is mostly long runs. `HUFFMAN_ONLY` writes every byte as a literal, for
+// data with no repeats to find.
+enum class Strategy { DEFAULT, RLE, HUFFMAN_ONLY };
+
+// How hard the encoder looks for matches. These follow zlib's parameters for each compression level.
+struct LzssEncoderConfig
+{
+  // The most hash chain entries to check for each match.
+  unsigned int max_chain_length;
+  // Stop searching once a match is at least this long.
+  unsigned int nice_length;
+  // Only check a quarter of the chain when looking ahead past a match at least this long.
+  unsigned int good_length;
+  // Look one position ahead for a longer match before taking one shorter than this. 0 takes every match right away.
+  unsigned int max_lazy_length;
+  // Positions inside matches longer than this are left out of the hash chains.
+  unsigned int max_insert_length;
+  // When not 0, blocks are parsed by cost instead, refining the cost model this many times.
+  unsigned int optimal_parse_iterations;
+  // Binary trees find long matches with fewer comparisons than hash chains, but take more work to insert into. A plain
+  // hash table makes one probe per position, and switches the encoder to its fastest mode, which also skips ahead
+  // through input that doesn't compress.
+  MatchFinderType match_finder_type;
+  // The other strategies ignore everything above.
+  Strategy strategy{ Strategy::DEFAULT };
+};
+
+const unsigned int MIN_LEVEL{ 1 };
+const unsigned int DEFAULT_LEVEL{ 6 };
+// Beyond the usual 1 to 9, for when compression time hardly matters.
+const unsigned int OPTIMAL_PARSE_LEVEL{ 10 };
+const unsigned int MAX_LEVEL{ OPTIMAL_PARSE_LEVEL };
+
+namespace detail {
+
+  // Levels 1 to 3 take matches greedily and skip inserting the insides of long ones, with level 1 looking for them in
+  // a plain hash table. Levels 4 to 9 use lazy matching, and level 10 optimal parsing. The last two search with binary
+  // trees.
+  inline constexpr std::array<LzssEncoderConfig, MAX_LEVEL - MIN_LEVEL + 1> LEVEL_CONFIGS{ {
+    { 1, 258, 258, 0, 0, 0, MatchFinderType::HASH_TABLE },
+    { 8, 16, 4, 0, 5, 0, MatchFinderType::HASH_CHAIN },
+    { 32, 32, 4, 0, 6, 0, MatchFinderType::HASH_CHAIN },
+    { 16, 16, 4, 4, constants::MAX_BACKREF_LENGTH, 0, MatchFinderType::HASH_CHAIN },
+    { 32, 32, 8, 16, constants::MAX_BACKREF_LENGTH, 0, MatchFinderType::HASH_CHAIN },
+    { 128, 128, 8, 16, constants::MAX_BACKREF_LENGTH, 0, MatchFinderType::HASH_CHAIN },
+    { 256, 128, 8, 32, constants::MAX_BACKREF_LENGTH, 0, MatchFinderType::HASH_CHAIN },
+    { 1024, 258, 32, 128, constants::MAX_BACKREF_LENGTH, 0, MatchFinderType::HASH_CHAIN },
+    { 4096, 258, 32, 258, constants::MAX_BACKREF_LENGTH, 0, MatchFinderType::BINARY_TREE },
+    { 1024, 258, 258, 0, constants::MAX_BACKREF_LENGTH, 5, MatchFinderType::BINARY_TREE },
+  } };
+
+}  // namespace detail
+
+constexpr LzssEncoderConfig get_level_config(unsigned int level)
+{
+  if (level < MIN_LEVEL || level > MAX_LEVEL) {
+    throw std::out_of_range("Invalid compression level.");
+  }
+  return detail::LEVEL_CONFIGS[level - MIN_LEVEL];
+}
+
+}  // namespace lzss
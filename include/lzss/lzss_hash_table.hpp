@@ -0,0 +1,60 @@
+#pragma once
+
+#include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+#include "lzss/lzss_window.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace lzss {
+
+// Finds earlier occurrences of strings in the input as cheaply as possible, with the same interface as
+// `LzssStringTable`. Only the most recent position for each four-byte hash is kept, so each search is a single probe,
+// and matches are often missed or shorter than they could be.
+//
+// Searching at a position also inserts it, and each position can only be searched once.
+class LzssHashTable
+{
+public:
+  LzssHashTable(const LzssEncoderConfig &config = get_level_config(MIN_LEVEL));
+
+  std::size_t append(std::string_view input, uint64_t position) { return window_.append(input, position); }
+  uint64_t get_end_position() const { return window_.get_end_position(); }
+  char get_byte(uint64_t position) const { return window_.get_byte(position); }
+
+  // Adds every position before `position` to the table, except for the last few in the window, which have to wait for
+  // more input to be hashed.
+  void insert_up_to(uint64_t position);
+
+  // Leaves every position before `position` that isn't inserted yet out of the table.
+  void skip_to(uint64_t position);
+
+  // Checks the last position with the same hash as `position` for a match longer than `min_length`, and no longer
+  // than `max_length`. Every position before `position` must already be inserted, and `position` must not be.
+  std::optional<BackReference> get_back_reference(uint64_t position,
+    unsigned int max_length,
+    unsigned int min_length = constants::MIN_BACKREF_LENGTH - 1);
+
+  // Appends the match found at `position`, if any, to `back_refs`.
+  void find_back_references(uint64_t position, unsigned int max_length, std::vector<BackReference> &back_refs);
+
+private:
+  static constexpr unsigned int HASH_BITS{ 14 };
+  static constexpr unsigned int HASH_SIZE{ 1U << HASH_BITS };
+  static constexpr unsigned int HASH_LENGTH{ 4 };
+  static constexpr uint64_t NO_POSITION{ UINT64_MAX };
+
+  unsigned int hash_at(uint64_t position) const;
+
+  LzssWindow window_{};
+
+  // `head_` holds the most recent position for each hash.
+  std::vector<uint64_t> head_;
+  uint64_t next_insert_position_{ 0 };
+};
+
+}  // namespace lzss
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace lzss {
+
+// How many bytes are read past the end of a match by `get_match_length()`. Buffers it runs over need this much
+// readable padding after the last byte that can be part of a match.
+inline constexpr unsigned int MATCH_LENGTH_OVERREAD{ 32 };
+
+// Returns the length of the common prefix of `string` and `search`, up to `max_length`. Bytes are compared in blocks,
+// 32 at a time with AVX2 and 8 at a time otherwise, so up to `MATCH_LENGTH_OVERREAD` bytes past `max_length` may be
+// read from both.
+inline unsigned int get_match_length(const uint8_t *string, const uint8_t *search, unsigned int max_length)
+{
+  unsigned int length{ 0 };
+
+#if defined(__AVX2__)
+  while (length < max_length) {
+    auto string_block{ _mm256_loadu_si256(reinterpret_cast<const __m256i *>(string + length)) };
+    auto search_block{ _mm256_loadu_si256(reinterpret_cast<const __m256i *>(search + length)) };
+    auto equal_mask{ static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(string_block, search_block))) };
+
+    if (equal_mask != UINT32_MAX) {
+      length += std::countr_one(equal_mask);
+      return std::min(length, max_length);
+    }
+    length += 32;
+  }
+#else
+  if constexpr (std::endian::native == std::endian::little) {
+    while (length < max_length) {
+      uint64_t string_word, search_word;
+      std::memcpy(&string_word, string + length, sizeof(string_word));
+      std::memcpy(&search_word, search + length, sizeof(search_word));
+
+      // The lowest set bit of the difference is in the first byte that doesn't match.
+      auto difference{ string_word ^ search_word };
+      if (difference != 0) {
+        length += std::countr_zero(difference) / 8;
+        return std::min(length, max_length);
+      }
+      length += 8;
+    }
+  } else {
+    while (length < max_length && string[length] == search[length]) {
+      length++;
+    }
+  }
+#endif
+
+  return std::min(length, max_length);
+}
+
+}  // namespace lzss
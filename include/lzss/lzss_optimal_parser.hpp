@@ -0,0 +1,68 @@
+#pragma once
+
+#include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_window.hpp"
+#include "prefix_codes/prefix_code_encoder.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace lzss {
+
+// Chooses between the literals and back-references available in a block by their cost in bits, rather than taking
+// the longest match at each step. Each iteration finds the cheapest parse with dynamic programming, then prices the
+// symbols for the next one with the prefix codes that parse would get.
+class LzssOptimalParser
+{
+public:
+  // A literal has a length of 1 and a distance of 0.
+  struct Step
+  {
+    uint16_t length;
+    uint16_t distance;
+  };
+
+  LzssOptimalParser(unsigned int num_iterations);
+
+  // `input` starts at `start_position`, and `back_refs` holds the back-references found at each position of it, as
+  // returned by `LzssStringTable::find_back_references()`. Those for `input[i]` run from `offsets[i]` up to
+  // `offsets[i + 1]`. Returns the cheapest parse found, from the start of `input`.
+  const std::vector<Step> &parse(std::string_view input,
+    uint64_t start_position,
+    const std::vector<BackReference> &back_refs,
+    const std::vector<std::size_t> &offsets);
+
+private:
+  static const unsigned int NUM_LL_CODES{ 286 };
+  static const unsigned int NUM_DISTANCE_CODES{ 30 };
+  static const unsigned int MAX_CODE_LENGTH{ 15 };
+
+  void set_initial_costs();
+  void find_cheapest_parse(std::string_view input,
+    uint64_t start_position,
+    const std::vector<BackReference> &back_refs,
+    const std::vector<std::size_t> &offsets);
+  // Builds prefix codes for the last parse and prices symbols with them. Returns the cost of the parse in bits.
+  uint64_t update_costs(std::string_view input);
+
+  const unsigned int num_iterations_;
+
+  // Costs in bits, including extra bits for lengths and distances.
+  std::array<unsigned int, NUM_LL_CODES> literal_costs_{};
+  std::array<unsigned int, constants::MAX_BACKREF_LENGTH + 1> length_costs_{};
+  std::array<unsigned int, NUM_DISTANCE_CODES> distance_code_costs_{};
+
+  // `path_costs_[i]` is the cost of the cheapest parse of the first `i` bytes, and `path_steps_[i]` the last step of it.
+  std::vector<uint64_t> path_costs_{};
+  std::vector<Step> path_steps_{};
+  std::vector<Step> steps_{};
+  std::vector<Step> best_steps_{};
+
+  prefix_codes::PrefixCodeEncoder ll_encoder_{ MAX_CODE_LENGTH };
+  prefix_codes::PrefixCodeEncoder distance_encoder_{ MAX_CODE_LENGTH };
+};
+
+}  // namespace lzss
@@ -1,43 +1,78 @@
 #pragma once
 
-#include <functional>
-#include <list>
+#include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+#include "lzss/lzss_window.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <optional>
-#include <string>
 #include <string_view>
+#include <vector>
 
 namespace lzss {
 
-struct BackReference
-{
-  unsigned int position;
-  unsigned int length;
-};
-
+// Finds earlier occurrences of strings in the input, zlib style. Input goes into a sliding window, and every position in
+// it is chained to the earlier positions that start with the same three bytes.
 class LzssStringTable
 {
 public:
-  LzssStringTable(unsigned int max_chain_length = 10);
+  LzssStringTable(const LzssEncoderConfig &config = get_level_config(DEFAULT_LEVEL));
+
+  std::size_t append(std::string_view input, uint64_t position) { return window_.append(input, position); }
+  uint64_t get_end_position() const { return window_.get_end_position(); }
+  char get_byte(uint64_t position) const { return window_.get_byte(position); }
 
-  void insert(std::string_view string, unsigned int position);
-  std::optional<BackReference> get_back_reference(std::string_view string) const;
+  // Adds every position before `position` to the hash chains, except for the last couple in the window, which have to
+  // wait for more input to be hashed.
+  void insert_up_to(uint64_t position);
 
-  unsigned int get_average_chain_length() const;
-  std::string to_string() const;
+  // Leaves every position before `position` that isn't inserted yet out of the hash chains.
+  void skip_to(uint64_t position);
+
+  // Looks for the longest earlier string matching the one at `position`, longer than `min_length` and no longer than
+  // `max_length`. The search follows the limits in the config, and stops early at a match of the nice length. Of
+  // equally long matches, the closest one wins. Every position before `position` must already be inserted.
+  std::optional<BackReference> get_back_reference(uint64_t position,
+    unsigned int max_length,
+    unsigned int min_length = constants::MIN_BACKREF_LENGTH - 1) const;
+
+  // Appends each match found at `position` that is longer than the ones before it to `back_refs`, so a match of any
+  // length up to the longest can be made from the closest back-reference at least that long.
+  void find_back_references(uint64_t position, unsigned int max_length, std::vector<BackReference> &back_refs) const;
 
 private:
-  std::size_t get_chain_index(std::string_view string) const;
+  static constexpr unsigned int HALF_WINDOW_SIZE{ LzssWindow::HALF_WINDOW_SIZE };
+  static constexpr unsigned int HASH_BITS{ 15 };
+  static constexpr unsigned int HASH_SIZE{ 1U << HASH_BITS };
+  static constexpr unsigned int HASH_SHIFT{ 5 };
+  static constexpr uint64_t NO_POSITION{ UINT64_MAX };
 
-  struct Entry
+  // Each byte shifts the hash by `HASH_SHIFT` bits, so after three bytes the hash only depends on those three bytes.
+  static unsigned int update_hash(unsigned int hash, uint8_t byte)
   {
-    std::string string;
-    unsigned int position;
-  };
+    return ((hash << HASH_SHIFT) ^ byte) & (HASH_SIZE - 1);
+  }
+  unsigned int hash_at(uint64_t position) const;
+
+  // Walks the hash chain for `position`, calling `handle_match` for each match longer than all earlier ones.
+  template<typename MatchHandler>
+  void search(uint64_t position, unsigned int max_length, unsigned int min_length, MatchHandler handle_match) const;
+
+  LzssWindow window_{};
+
+  // `head_` holds the most recent position for each hash, and `prev_` links each position in the last
+  // `HALF_WINDOW_SIZE` bytes to the previous one with the same hash.
+  std::vector<uint64_t> head_;
+  std::vector<uint64_t> prev_;
+  uint64_t next_insert_position_{ 0 };
+  unsigned int insert_hash_{ 0 };
+  // The rolling hash has to start over after positions are skipped.
+  uint64_t hash_start_position_{ 0 };
 
-  static const unsigned int MAX_CHAINS{ 65536 };
-  std::list<Entry> chains_[MAX_CHAINS];
-  std::hash<std::string> hash_{};
   const unsigned int max_chain_length_;
+  const unsigned int nice_length_;
+  const unsigned int good_length_;
 };
 
 }  // namespace lzss
@@ -1,59 +1,113 @@
 #pragma once
 
+#include "lzss/lzss_block_splitter.hpp"
+#include "lzss/lzss_code_tables.hpp"
+#include "lzss/lzss_constants.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace lzss {
 
-enum class LzssSymbolType { LITERAL, LENGTH, DISTANCE };
+// The length/literal code that ends every block.
+const unsigned int END_OF_BLOCK_CODE{ 256 };
 
+// A literal or a whole back-reference, packed into 4 bytes. Codes and extra bits are looked up when the symbol is
+// written, rather than stored.
 class LzssSymbol
 {
 public:
-  LzssSymbol(LzssSymbolType type, unsigned int value);
+  LzssSymbol(unsigned char literal) : length_or_literal_{ literal } {}
+  LzssSymbol(unsigned int length, unsigned int distance)
+    : length_or_literal_{ static_cast<uint16_t>(length) }, distance_{ static_cast<uint16_t>(distance) }
+  {
+    assert(length >= constants::MIN_BACKREF_LENGTH && length <= constants::MAX_BACKREF_LENGTH
+           && "trying to create invalid length");
+    assert(distance >= 1 && distance <= constants::MAX_BACKREF_DISTANCE && "trying to create invalid distance");
+  }
 
-  auto get_type() const { return type_; }
-  auto get_value() const { return value_; }
+  bool is_literal() const { return distance_ == 0; }
 
-  auto get_code() const { return code_; }
-  auto get_extra_bits() const
+  unsigned char get_literal() const
+  {
+    assert(is_literal() && "back-references do not have a literal");
+    return static_cast<unsigned char>(length_or_literal_);
+  }
+  unsigned int get_length() const
   {
-    assert(type_ != LzssSymbolType::LITERAL && "literals do not have extra bits");
-    return extra_bits_;
+    assert(!is_literal() && "literals do not have a length");
+    return length_or_literal_;
   }
-  auto get_offset() const
+  unsigned int get_distance() const
   {
-    assert(type_ != LzssSymbolType::LITERAL && "literals do not have offsets");
-    return offset_;
+    assert(!is_literal() && "literals do not have a distance");
+    return distance_;
   }
 
 private:
-  void lookup_code_table_data();
-
-  const LzssSymbolType type_;
-  const unsigned int value_;
-
-  unsigned int code_;
-  unsigned int extra_bits_;
-  unsigned int offset_;
+  uint16_t length_or_literal_;
+  uint16_t distance_{ 0 };
 };
 
-extern const LzssSymbol END_OF_BLOCK_MARKER;
+static_assert(sizeof(LzssSymbol) == 4);
 
-class LzssSymbolList
+// Holds the symbols for one block. The buffer is allocated once, at a fixed capacity, and the encoder stops adding to
+// it when it fills up, so a block never holds more than `CAPACITY` symbols. It also stops once the symbols change
+// enough that a new block would be better, as decided by an `LzssBlockSplitter`.
+//
+// The frequencies of the length/literal and distance codes are counted as symbols are added, so the block encoder can
+// build its codes without another pass over the symbols. The end of block code isn't counted.
+class LzssSymbolBuffer
 {
 public:
-  void add(const LzssSymbol &symbol);
-  void clear();
+  // As in zlib, 16K symbols, which is 64 KB.
+  static const std::size_t CAPACITY{ 16384 };
+
+  LzssSymbolBuffer() { buffer_.reserve(CAPACITY); }
+
+  void add(LzssSymbol symbol)
+  {
+    assert(!is_full() && "adding a symbol to a full buffer");
+    buffer_.push_back(symbol);
+
+    if (symbol.is_literal()) {
+      ll_frequencies_[symbol.get_literal()]++;
+    } else {
+      ll_frequencies_[code_tables::get_length_entry_by_length(symbol.get_length()).code]++;
+      distance_frequencies_[code_tables::get_distance_entry_by_distance(symbol.get_distance()).code]++;
+    }
+
+    block_splitter_.update(ll_frequencies_, buffer_.size());
+  }
+  void clear()
+  {
+    buffer_.clear();
+    ll_frequencies_.fill(0);
+    distance_frequencies_.fill(0);
+    block_splitter_.clear();
+  }
+
+  bool is_full() const { return buffer_.size() == CAPACITY; }
+  bool should_end_block() const { return is_full() || block_splitter_.should_end_block(); }
+  std::size_t get_free_space() const { return CAPACITY - buffer_.size(); }
+
+  const auto &get_ll_frequencies() const { return ll_frequencies_; }
+  const auto &get_distance_frequencies() const { return distance_frequencies_; }
 
   std::string to_string() const;
 
-  auto begin() const { return list_.begin(); }
-  auto end() const { return list_.end(); }
+  auto begin() const { return buffer_.begin(); }
+  auto end() const { return buffer_.end(); }
 
 private:
-  std::vector<LzssSymbol> list_{};
+  std::vector<LzssSymbol> buffer_{};
+  prefix_codes::FrequencyTable ll_frequencies_{};
+  prefix_codes::FrequencyTable distance_frequencies_{};
+  LzssBlockSplitter block_splitter_{};
 };
 
 }  // namespace lzss
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "lzss/lzss_match_length.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace lzss {
+
+struct BackReference
+{
+  uint64_t position;
+  unsigned int length;
+};
+
+// The sliding window that match finders search. Positions are counted from the start of the input, so matches can
+// reach back across calls to `LzssEncoder::encode()`.
+class LzssWindow
+{
+public:
+  LzssWindow();
+
+  // Copies as much of `input` as fits onto the end of the window, and returns the number of bytes taken. When the
+  // window is full, its older half is dropped once nothing within reach of `position` would be lost.
+  std::size_t append(std::string_view input, uint64_t position);
+
+  // The positions of the first byte in the window, and just past the last.
+  uint64_t get_start_position() const { return start_; }
+  uint64_t get_end_position() const { return start_ + end_; }
+
+  char get_byte(uint64_t position) const { return static_cast<char>(bytes_[position - start_]); }
+  // There are `PADDING_SIZE` readable bytes past the end of the window.
+  const uint8_t *get_bytes(uint64_t position) const { return &bytes_[position - start_]; }
+
+  // The window holds two halves of `HALF_WINDOW_SIZE` bytes. Matches can't reach back further than `MAX_DISTANCE`,
+  // which leaves room in the window for the lookahead needed to find the longest possible match.
+  static const unsigned int HALF_WINDOW_SIZE{ 32768 };
+  static const unsigned int MIN_LOOKAHEAD{ 258 + 3 + 1 };
+  static const unsigned int MAX_DISTANCE{ HALF_WINDOW_SIZE - MIN_LOOKAHEAD };
+
+private:
+  static const unsigned int WINDOW_SIZE{ 2 * HALF_WINDOW_SIZE };
+  // Enough for `get_match_length()` to read past the end of a match.
+  static const unsigned int PADDING_SIZE{ MATCH_LENGTH_OVERREAD };
+
+  void slide();
+
+  std::vector<uint8_t> bytes_;
+  uint64_t start_{ 0 };
+  std::size_t end_{ 0 };
+};
+
+}  // namespace lzss
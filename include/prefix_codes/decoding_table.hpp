@@ -0,0 +1,208 @@
+#pragma once
+
+#include "bit_io/bit_reversal.hpp"
+#include "prefix_codes/canonical_codes.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <string>
+
+namespace prefix_codes {
+
+class DecodingError : public std::exception
+{
+public:
+  DecodingError(const std::string &message) : message_{ message } {}
+
+  const char *what() const noexcept { return message_.c_str(); }
+
+private:
+  const std::string message_;
+};
+
+// Lookup table for decoding a prefix code, built from its code lengths. Tables are plain data, so they can be built at
+// compile time or shared between decoders.
+class DecodingTable
+{
+public:
+  enum class EntryType : uint8_t { INVALID, SYMBOL, SUBTABLE };
+
+  // For symbols, `value` is the symbol and `length` is its code length. For subtables, `value` is the offset of the
+  // subtable and `length` is the number of bits used to index it.
+  struct Entry
+  {
+    uint16_t value;
+    uint8_t length;
+    EntryType type;
+  };
+
+  static const unsigned int MAX_CODE_LENGTH{ 15 };
+
+  constexpr DecodingTable() = default;
+  constexpr explicit DecodingTable(const CodeLengthTable &code_length_table) { build(code_length_table); }
+
+  constexpr void build(const CodeLengthTable &code_length_table);
+
+  // Looks up the code at the start of `bits`, which must hold at least the next `MAX_CODE_LENGTH` bits of input.
+  constexpr Entry lookup(uint64_t bits) const
+  {
+    auto entry{ entries_[bits & (PRIMARY_TABLE_SIZE - 1)] };
+    if (entry.type == EntryType::SUBTABLE) {
+      entry = entries_[entry.value + ((bits >> PRIMARY_BITS) & ((1U << entry.length) - 1))];
+    }
+    return entry;
+  }
+
+private:
+  // Symbols are decoded by looking up the next `PRIMARY_BITS` bits of input in the primary table, which takes up the
+  // start of `entries_`. Codes longer than that continue into a second-level table stored after the primary table.
+  static const unsigned int PRIMARY_BITS{ 9 };
+  static const unsigned int PRIMARY_TABLE_SIZE{ 1U << PRIMARY_BITS };
+  static const unsigned int MAX_TABLE_SIZE{ 2048 };
+
+  std::array<Entry, MAX_TABLE_SIZE> entries_{};
+};
+
+// Lookup table for decoding runs of consecutive short literals at once, built on top of a `DecodingTable`. Literals are
+// the symbols below `LITERAL_LIMIT`, as in the length/literal alphabet.
+class MultiLiteralTable
+{
+public:
+  static const unsigned int LITERAL_LIMIT{ 256 };
+  static const unsigned int MAX_LITERALS_PER_LOOKUP{ 3 };
+
+  // A run of literals whose codes all fit in the next `LOOKUP_BITS` bits of input. Entries with a `count` of zero fall
+  // back to single-symbol decoding.
+  struct Entry
+  {
+    std::array<uint8_t, MAX_LITERALS_PER_LOOKUP> literals;
+    uint8_t count;
+    uint8_t length;
+  };
+
+  // The table is indexed by more bits than the primary decoding table, so that runs of typical 4 to 6 bit literal codes
+  // fit in one entry.
+  static const unsigned int LOOKUP_BITS{ 12 };
+
+  constexpr MultiLiteralTable() = default;
+  constexpr explicit MultiLiteralTable(const DecodingTable &decoding_table) { build(decoding_table); }
+
+  constexpr void build(const DecodingTable &decoding_table);
+
+  constexpr const Entry &lookup(uint64_t bits) const { return entries_[bits & (TABLE_SIZE - 1)]; }
+
+private:
+  static const unsigned int TABLE_SIZE{ 1U << LOOKUP_BITS };
+
+  std::array<Entry, TABLE_SIZE> entries_{};
+};
+
+constexpr void DecodingTable::build(const CodeLengthTable &code_length_table)
+{
+  entries_.fill({});
+
+  // Make sure the code lengths describe a complete prefix code. Anything else would leave gaps in the table, except for
+  // the degenerate cases of no codes or a single code.
+  unsigned int kraft_sum{ 0 };
+  unsigned int num_codes{ 0 };
+  for (auto length : code_length_table) {
+    if (length == 0) {
+      continue;
+    }
+    if (length > MAX_CODE_LENGTH) {
+      throw DecodingError("Code length " + std::to_string(length) + " is too long.");
+    }
+    kraft_sum += 1U << (MAX_CODE_LENGTH - length);
+    num_codes++;
+  }
+
+  if (kraft_sum > (1U << MAX_CODE_LENGTH)) {
+    throw DecodingError("Code lengths are over-subscribed.");
+  }
+  if (kraft_sum < (1U << MAX_CODE_LENGTH) && num_codes > 1) {
+    throw DecodingError("Code lengths are incomplete.");
+  }
+
+  auto code_table{ compute_canonical_code_table(code_length_table) };
+
+  // Codes are read low bit first, so the table is indexed by the codes with their bits reversed. Short codes fill every
+  // primary entry that starts with them; long codes are only noted here so their subtables can be sized.
+  std::array<uint8_t, PRIMARY_TABLE_SIZE> subtable_bits{};
+
+  for (unsigned int symbol{ 0 }; symbol < code_length_table.size(); symbol++) {
+    auto length{ code_length_table[symbol] };
+    if (length == 0) {
+      continue;
+    }
+
+    auto reversed_code{ bit_io::reverse_bits(code_table[symbol], length) };
+
+    if (length <= PRIMARY_BITS) {
+      for (auto index{ reversed_code }; index < PRIMARY_TABLE_SIZE; index += 1U << length) {
+        entries_[index] = { static_cast<uint16_t>(symbol), static_cast<uint8_t>(length), EntryType::SYMBOL };
+      }
+    } else {
+      auto &bits{ subtable_bits[reversed_code & (PRIMARY_TABLE_SIZE - 1)] };
+      bits = std::max(bits, static_cast<uint8_t>(length - PRIMARY_BITS));
+    }
+  }
+
+  unsigned int table_size{ PRIMARY_TABLE_SIZE };
+  for (unsigned int index{ 0 }; index < PRIMARY_TABLE_SIZE; index++) {
+    if (subtable_bits[index] == 0) {
+      continue;
+    }
+
+    entries_[index] = { static_cast<uint16_t>(table_size), subtable_bits[index], EntryType::SUBTABLE };
+    table_size += 1U << subtable_bits[index];
+
+    if (table_size > MAX_TABLE_SIZE) {
+      throw DecodingError("Decoding table is too large.");
+    }
+  }
+
+  for (unsigned int symbol{ 0 }; symbol < code_length_table.size(); symbol++) {
+    auto length{ code_length_table[symbol] };
+    if (length <= PRIMARY_BITS) {
+      continue;
+    }
+
+    auto reversed_code{ bit_io::reverse_bits(code_table[symbol], length) };
+    auto subtable{ entries_[reversed_code & (PRIMARY_TABLE_SIZE - 1)] };
+    auto subtable_size{ 1U << subtable.length };
+
+    for (auto index{ reversed_code >> PRIMARY_BITS }; index < subtable_size; index += 1U << (length - PRIMARY_BITS)) {
+      entries_[subtable.value + index] = { static_cast<uint16_t>(symbol),
+        static_cast<uint8_t>(length),
+        EntryType::SYMBOL };
+    }
+  }
+}
+
+constexpr void MultiLiteralTable::build(const DecodingTable &decoding_table)
+{
+  for (unsigned int index{ 0 }; index < TABLE_SIZE; index++) {
+    Entry multi_entry{};
+
+    // Keep decoding literals from the remaining index bits as long as each whole code is known to be in them. The bits
+    // past the end of the index read as zeros here, which doesn't matter for codes that end before them.
+    while (multi_entry.count < MAX_LITERALS_PER_LOOKUP) {
+      auto entry{ decoding_table.lookup(index >> multi_entry.length) };
+
+      if (entry.type != DecodingTable::EntryType::SYMBOL || entry.length > LOOKUP_BITS - multi_entry.length
+          || entry.value >= LITERAL_LIMIT) {
+        break;
+      }
+
+      multi_entry.literals[multi_entry.count++] = static_cast<uint8_t>(entry.value);
+      multi_entry.length += entry.length;
+    }
+
+    entries_[index] = multi_entry;
+  }
+}
+
+}  // namespace prefix_codes
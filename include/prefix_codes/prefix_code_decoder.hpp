@@ -1,52 +1,32 @@
 #pragma once
 
 #include "bit_io/bit_reader.hpp"
-#include "prefix_codes/prefix_code_types.hpp"
+#include "prefix_codes/decoding_table.hpp"
 
-#include <exception>
-#include <memory>
-#include <optional>
+#include <array>
 
 namespace prefix_codes {
 
+// Reads symbols from a bit stream using prebuilt decoding tables. The tables are only referenced, and must outlive the
+// decoder.
 class PrefixCodeDecoder
 {
 public:
-  PrefixCodeDecoder(bit_io::BitReader &bit_reader, const CodeLengthTable &code_length_table);
+  static const unsigned int MAX_SYMBOLS_PER_LOOKUP{ MultiLiteralTable::MAX_LITERALS_PER_LOOKUP };
+  using SymbolBuffer = std::array<unsigned int, MAX_SYMBOLS_PER_LOOKUP>;
 
-  void initialize();
-  unsigned int decode_symbol();
+  PrefixCodeDecoder(bit_io::BitReader &bit_reader, const DecodingTable &table);
 
-private:
-  struct Node;
-  using NodePtr = std::shared_ptr<Node>;
-
-  struct Node
-  {
-    std::optional<unsigned int> symbol;
-    NodePtr left{ nullptr };
-    NodePtr right{ nullptr };
-  };
-
-  void compute_code_table();
-  void build_tree();
-  void insert_symbol(unsigned int symbol, unsigned int code);
-
-  NodePtr tree_root_;
-  CodeTable code_table_;
-  const CodeLengthTable &code_length_table_;
-  bit_io::BitReader &bit_reader_;
-};
+  // With a multi-literal table, `decode_symbols()` can return a run of consecutive short literals from a single lookup.
+  PrefixCodeDecoder(bit_io::BitReader &bit_reader, const DecodingTable &table, const MultiLiteralTable &multi_table);
 
-class DecodingError : public std::exception
-{
-public:
-  DecodingError(const std::string &message) : message_{ message } {}
-
-  const char *what() const noexcept { return message_.c_str(); }
+  unsigned int decode_symbol();
+  unsigned int decode_symbols(SymbolBuffer &symbols);
 
 private:
-  const std::string message_;
+  bit_io::BitReader &bit_reader_;
+  const DecodingTable &table_;
+  const MultiLiteralTable *multi_table_{ nullptr };
 };
 
 }  // namespace prefix_codes
@@ -2,9 +2,8 @@
 
 #include "prefix_codes/prefix_code_types.hpp"
 
-#include <memory>
-#include <optional>
-#include <vector>
+#include <array>
+#include <cstdint>
 
 namespace prefix_codes {
 
@@ -19,28 +18,23 @@ public:
   const auto &get_code_length_table() const { return code_length_table_; }
 
 private:
-  struct PackageNode;
-  using PackageNodePtr = std::shared_ptr<PackageNode>;
-  using PackageList = std::vector<PackageNodePtr>;
-
-  struct PackageNode
-  {
-    std::optional<unsigned int> symbol;
-    unsigned int weight;
-    PackageNodePtr left{ nullptr };
-    PackageNodePtr right{ nullptr };
-  };
+  // Code lengths are computed with package-merge. Each list holds the symbols in increasing order of frequency merged
+  // with packages of pairs from the previous list, so it never has more than `2 * MAX_NUM_SYMBOLS` items.
+  static const unsigned int MAX_CODE_LENGTH{ 15 };
+  static const unsigned int MAX_LIST_SIZE{ 2 * MAX_NUM_SYMBOLS };
 
   void compute_code_length_table(const FrequencyTable &frequencies);
   void compute_code_table();
 
-  void expand_package(PackageNodePtr package);
-  static PackageList package(const PackageList &list);
-  static PackageList merge(const PackageList &list1, const PackageList &list2);
-
   const unsigned int max_code_length_;
-  CodeLengthTable code_length_table_;
-  CodeTable code_table_;
+  CodeLengthTable code_length_table_{};
+  CodeTable code_table_{};
+
+  // Scratch space for package-merge, kept here so that encoding doesn't allocate. `is_package_[level][i]` records
+  // whether item `i` of the list for that level is a package or a symbol.
+  std::array<uint16_t, MAX_NUM_SYMBOLS> sorted_symbols_{};
+  std::array<std::array<uint64_t, MAX_LIST_SIZE>, 2> weights_{};
+  std::array<std::array<bool, MAX_LIST_SIZE>, MAX_CODE_LENGTH> is_package_{};
 };
 
 }  // namespace prefix_codes
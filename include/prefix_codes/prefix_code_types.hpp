@@ -1,12 +1,16 @@
 #pragma once
 
-#include <map>
-#include <unordered_map>
+#include <array>
 
 namespace prefix_codes {
 
-using FrequencyTable = std::unordered_map<unsigned int, unsigned int>;
-using CodeTable = std::unordered_map<unsigned int, unsigned int>;
-using CodeLengthTable = std::map<unsigned int, unsigned int>;
+// All tables are indexed by symbol and sized for the largest DEFLATE alphabet, the 288 length/literal codes. The
+// distance and CL alphabets just use a prefix of each table. A frequency or code length of zero means the symbol
+// doesn't occur.
+const unsigned int MAX_NUM_SYMBOLS{ 288 };
+
+using FrequencyTable = std::array<unsigned int, MAX_NUM_SYMBOLS>;
+using CodeTable = std::array<unsigned int, MAX_NUM_SYMBOLS>;
+using CodeLengthTable = std::array<unsigned int, MAX_NUM_SYMBOLS>;
 
 }  // namespace prefix_codes
@@ -1,58 +1,123 @@
 #include "bit_io/bit_reader.hpp"
+#include "bit_io/bit_reversal.hpp"
+#include "bit_io/byte_source.hpp"
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <istream>
+#include <memory>
 
 namespace bit_io {
 
-BitReader::BitReader(std::istream &input) : input_{ input } {}
+BitReader::BitReader(ByteSource &source) : source_{ source } {}
+
+BitReader::BitReader(std::istream &input)
+  : owned_source_{ std::make_unique<StreamByteSource>(input) }, source_{ *owned_source_ }
+{}
 
 bool BitReader::get_single_bit()
 {
-  if (current_bit_ == 0) {
-    current_byte_ = input_.get();
-  }
+  return get_bits(1);
+}
+
+uint64_t BitReader::get_bits(int num_bits, bool low_bit_first)
+{
+  assert(num_bits > 0 && num_bits <= 64);
+
+  uint64_t value;
 
-  bool value = current_byte_ & (1 << current_bit_);
+  if (num_bits <= MAX_PEEK_BITS) {
+    value = peek_bits(num_bits);
+    consume_bits(num_bits);
+  } else {
+    value = peek_bits(32);
+    consume_bits(32);
+    value |= peek_bits(num_bits - 32) << 32;
+    consume_bits(num_bits - 32);
+  }
 
-  ++current_bit_;
-  if (current_bit_ == 8) {
-    current_bit_ = 0;
+  if (!low_bit_first) {
+    value = reverse_bits(value, num_bits);
   }
 
   return value;
 }
 
-uint64_t BitReader::get_bits(int num_bits, bool low_bit_first)
+uint64_t BitReader::peek_bits(int num_bits)
 {
-  assert(num_bits > 0 && num_bits <= 64);
+  assert(num_bits > 0 && num_bits <= MAX_PEEK_BITS);
 
-  uint64_t value = 0;
+  if (bit_count_ < num_bits) {
+    refill();
+  }
 
-  if (low_bit_first) {
-    for (int i = 0; i < num_bits; i++) {
-      value |= (static_cast<uint64_t>(get_single_bit()) << i);
-    }
-  } else {
-    for (int i = num_bits - 1; i >= 0; i--) {
-      value |= (static_cast<uint64_t>(get_single_bit()) << i);
+  return bit_buffer_ & ((uint64_t{ 1 } << num_bits) - 1);
+}
+
+void BitReader::consume_bits(int num_bits)
+{
+  assert(num_bits > 0 && num_bits <= MAX_PEEK_BITS);
+
+  if (bit_count_ < num_bits) {
+    refill();
+    if (bit_count_ < num_bits) {
+      eof_ = true;
+      bit_buffer_ = 0;
+      bit_count_ = 0;
+      return;
     }
   }
 
-  return value;
+  bit_buffer_ >>= num_bits;
+  bit_count_ -= num_bits;
 }
 
 void BitReader::align_to_byte()
 {
-  while (current_bit_ != 0) {
-    get_single_bit();
+  // Whole bytes are always loaded into the bit buffer, so anything past a multiple of 8 is left over from the byte
+  // currently being read.
+  if (bit_count_ % 8 != 0) {
+    consume_bits(bit_count_ % 8);
   }
 }
 
 bool BitReader::eof() const
 {
-  return input_.eof();
+  return eof_;
+}
+
+void BitReader::refill()
+{
+  if (block_.size() - block_pos_ >= 8) {
+    // Fast path: load a whole word and keep as many of its bytes as fit.
+    uint64_t word{ 0 };
+    for (int i{ 0 }; i < 8; i++) {
+      word |= static_cast<uint64_t>(block_[block_pos_ + i]) << (8 * i);
+    }
+
+    int num_bytes{ (63 - bit_count_) / 8 };
+    bit_buffer_ |= word << bit_count_;
+    bit_count_ += 8 * num_bytes;
+    bit_buffer_ &= (uint64_t{ 1 } << bit_count_) - 1;
+    block_pos_ += num_bytes;
+    return;
+  }
+
+  while (bit_count_ <= 56) {
+    if (block_pos_ == block_.size() && !read_block()) {
+      break;
+    }
+    bit_buffer_ |= static_cast<uint64_t>(block_[block_pos_++]) << bit_count_;
+    bit_count_ += 8;
+  }
+}
+
+bool BitReader::read_block()
+{
+  block_ = source_.read_block();
+  block_pos_ = 0;
+  return !block_.empty();
 }
 
 }  // namespace bit_io
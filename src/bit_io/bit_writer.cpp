@@ -1,50 +1,72 @@
 #include "bit_io/bit_writer.hpp"
+#include "bit_io/byte_sink.hpp"
 
-#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <ostream>
+#include <span>
 
 namespace bit_io {
 
-BitWriter::BitWriter(std::ostream &output) : output_{ output } {}
+BitWriter::BitWriter(ByteSink &sink) : sink_{ sink }, byte_buffer_(BYTE_BUFFER_SIZE) {}
 
-void BitWriter::put_single_bit(bool value)
+BitWriter::BitWriter(std::ostream &output)
+  : owned_sink_{ std::make_unique<StreamByteSink>(output) }, sink_{ *owned_sink_ }, byte_buffer_(BYTE_BUFFER_SIZE)
+{}
+
+void BitWriter::pad_to_byte()
 {
-  current_byte_ |= (static_cast<uint8_t>(value) << current_bit_);
+  if (bit_count_ % 8 != 0) {
+    // The unused bits of the accumulator are always zero, so padding just means counting them as written.
+    bit_count_ += 8 - bit_count_ % 8;
+  }
 
-  ++current_bit_;
-  if (current_bit_ == 8) {
-    output_.put(current_byte_);
-    current_bit_ = 0;
-    current_byte_ = 0;
+  if (bit_count_ == 64) {
+    flush_bit_buffer();
+    bit_count_ = 0;
+    bit_buffer_ = 0;
   }
 }
 
-void BitWriter::put_bits(uint64_t value, int num_bits, bool low_bit_first)
+void BitWriter::finish()
 {
-  assert(num_bits > 0 && num_bits <= 64);
+  pad_to_byte();
+  flush_whole_bytes();
+  flush_byte_buffer();
+}
 
-  if (low_bit_first) {
-    for (int i = 0; i < num_bits; i++) {
-      put_single_bit(value & (1 << i));
-    }
-  } else {
-    for (int i = num_bits - 1; i >= 0; i--) {
-      put_single_bit(value & (1 << i));
-    }
+void BitWriter::flush_bit_buffer()
+{
+  if (byte_count_ + 8 > byte_buffer_.size()) {
+    flush_byte_buffer();
+  }
+
+  for (int i{ 0 }; i < 8; i++) {
+    byte_buffer_[byte_count_ + i] = static_cast<std::byte>((bit_buffer_ >> (8 * i)) & 0xFF);
   }
+  byte_count_ += 8;
 }
 
-void BitWriter::pad_to_byte()
+void BitWriter::flush_whole_bytes()
 {
-  while (current_bit_ != 0) {
-    put_single_bit(false);
+  while (bit_count_ >= 8) {
+    if (byte_count_ == byte_buffer_.size()) {
+      flush_byte_buffer();
+    }
+    byte_buffer_[byte_count_++] = static_cast<std::byte>(bit_buffer_ & 0xFF);
+    bit_buffer_ >>= 8;
+    bit_count_ -= 8;
   }
 }
 
-void BitWriter::finish()
+void BitWriter::flush_byte_buffer()
 {
-  pad_to_byte();
+  if (byte_count_ > 0) {
+    sink_.write(std::span{ byte_buffer_ }.first(byte_count_));
+    flushed_byte_count_ += byte_count_;
+    byte_count_ = 0;
+  }
 }
 
 }  // namespace bit_io
@@ -0,0 +1,30 @@
+#include "bit_io/byte_sink.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+#include <span>
+
+namespace bit_io {
+
+void StreamByteSink::write(std::span<const std::byte> bytes)
+{
+  output_.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+void VectorByteSink::write(std::span<const std::byte> bytes)
+{
+  output_.insert(output_.end(), bytes.begin(), bytes.end());
+}
+
+void SpanByteSink::write(std::span<const std::byte> bytes)
+{
+  if (bytes.size() > output_.size() - size_) {
+    throw ByteSinkError("Output buffer is full.");
+  }
+
+  std::copy(bytes.begin(), bytes.end(), output_.begin() + size_);
+  size_ += bytes.size();
+}
+
+}  // namespace bit_io
@@ -0,0 +1,24 @@
+#include "bit_io/byte_source.hpp"
+
+#include <cstddef>
+#include <istream>
+#include <span>
+
+namespace bit_io {
+
+StreamByteSource::StreamByteSource(std::istream &input) : input_{ input }, block_(BLOCK_SIZE) {}
+
+std::span<const std::byte> StreamByteSource::read_block()
+{
+  input_.read(reinterpret_cast<char *>(block_.data()), block_.size());
+  return { block_.data(), static_cast<std::size_t>(input_.gcount()) };
+}
+
+std::span<const std::byte> SpanByteSource::read_block()
+{
+  auto block{ input_ };
+  input_ = {};
+  return block;
+}
+
+}  // namespace bit_io
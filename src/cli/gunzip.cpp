@@ -1,14 +1,35 @@
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
 #include "gzip/gzip_reader.hpp"
+#include "prefix_codes/decoding_table.hpp"
 
 #include <cstdlib>
 #include <iostream>
+#include <string_view>
 
-int main()
+int main(int argc, char *argv[])
 {
+  std::ios::sync_with_stdio(false);
+
+  // `--stats` reports how often the decoding tables of dynamic blocks were reused.
+  bool print_stats{ argc > 1 && std::string_view{ argv[1] } == "--stats" };
+
+  bit_io::StreamByteSource input{ std::cin };
+  bit_io::StreamByteSink output{ std::cout };
+  gzip::GzipReader reader{ input, output };
+
   try {
-    gzip::GzipReader{ std::cin, std::cout }.read();
+    reader.read();
   } catch (const gzip::GzipReaderError &e) {
     std::cerr << "Error: " << e.what() << std::endl;
     std::exit(1);
+  } catch (const prefix_codes::DecodingError &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    std::exit(1);
+  }
+
+  if (print_stats) {
+    const auto &cache{ reader.get_decoding_table_cache() };
+    std::cerr << "Decoding table cache: " << cache.get_hits() << " hits, " << cache.get_misses() << " misses\n";
   }
 }
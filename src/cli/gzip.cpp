@@ -1,8 +1,63 @@
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
 #include "gzip/gzip_writer.hpp"
+#include "lzss/lzss_encoder_config.hpp"
 
+#include <charconv>
+#include <cstdlib>
 #include <iostream>
+#include <string_view>
+#include <system_error>
 
-int main()
+int main(int argc, char *argv[])
 {
-  gzip::GzipWriter{ std::cin, std::cout }.write();
+  std::ios::sync_with_stdio(false);
+
+  // Like gzip, `-1` to `-9` set the compression level, with `--fast` and `--best` standing for the two ends. `-10`
+  // goes further, with optimal parsing. `--rle` and `--huffman-only` pick one of zlib's other strategies instead.
+  unsigned int level{ lzss::DEFAULT_LEVEL };
+  auto strategy{ lzss::Strategy::DEFAULT };
+
+  for (int i{ 1 }; i < argc; i++) {
+    std::string_view arg{ argv[i] };
+
+    if (arg == "--fast") {
+      level = lzss::MIN_LEVEL;
+      continue;
+    }
+    if (arg == "--best") {
+      level = lzss::OPTIMAL_PARSE_LEVEL - 1;
+      continue;
+    }
+    if (arg == "--rle") {
+      strategy = lzss::Strategy::RLE;
+      continue;
+    }
+    if (arg == "--huffman-only") {
+      strategy = lzss::Strategy::HUFFMAN_ONLY;
+      continue;
+    }
+
+    unsigned int arg_level{ 0 };
+    if (arg.length() >= 2 && arg[0] == '-') {
+      auto [end, error]{ std::from_chars(arg.data() + 1, arg.data() + arg.length(), arg_level) };
+      if (error != std::errc{} || end != arg.data() + arg.length()) {
+        arg_level = 0;
+      }
+    }
+
+    if (arg_level < lzss::MIN_LEVEL || arg_level > lzss::MAX_LEVEL) {
+      std::cerr << "Usage: " << argv[0] << " [-1 ... -10 | --fast | --best] [--rle | --huffman-only] < input > output.gz"
+                << std::endl;
+      std::exit(1);
+    }
+    level = arg_level;
+  }
+
+  bit_io::StreamByteSource input{ std::cin };
+  bit_io::StreamByteSink output{ std::cout };
+  auto config{ lzss::get_level_config(level) };
+  config.strategy = strategy;
+
+  gzip::GzipWriter{ input, output, config }.write();
 }
@@ -0,0 +1,346 @@
+#include "gzip/block_encoder.hpp"
+#include "bit_io/bit_counter.hpp"
+#include "bit_io/bit_reversal.hpp"
+#include "bit_io/bit_writer.hpp"
+#include "gzip/emission_table.hpp"
+#include "gzip/fixed_code_tables.hpp"
+#include "lzss/lzss_code_tables.hpp"
+#include "lzss/lzss_symbol.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+
+namespace gzip {
+
+namespace {
+
+  const unsigned int END_OF_BLOCK{ 256 };
+
+}  // namespace
+
+void BlockEncoder::prepare(std::string_view input, const lzss::LzssSymbolBuffer &symbol_buffer, bool is_storable)
+{
+  input_ = input;
+  is_storable_ = is_storable && input.length() <= MAX_STORED_BLOCK_LENGTH;
+  symbol_buffer_ = &symbol_buffer;
+
+  compute_dynamic_codes();
+}
+
+uint64_t BlockEncoder::get_block_size(BlockType block_type, uint64_t bit_position) const
+{
+  // The last block flag and the block type.
+  const uint64_t BLOCK_HEADER_SIZE{ 3 };
+
+  switch (block_type) {
+    using enum BlockType;
+
+    case STORED:
+      assert(is_storable_ && "block can't be stored");
+      // Padding to a byte boundary, then the length and its complement, then the bytes.
+      return BLOCK_HEADER_SIZE + (8 - (bit_position + BLOCK_HEADER_SIZE) % 8) % 8 + 32 + 8 * input_.length();
+    case FIXED:
+      return BLOCK_HEADER_SIZE
+             + get_symbols_size(fixed_code_tables::LL_CODE_LENGTHS, fixed_code_tables::DISTANCE_CODE_LENGTHS);
+    case DYNAMIC:
+      return BLOCK_HEADER_SIZE + dynamic_header_size_
+             + get_symbols_size(ll_encoder_.get_code_length_table(), distance_encoder_.get_code_length_table());
+  }
+  return 0;
+}
+
+BlockEncoder::BlockType BlockEncoder::get_smallest_block_type(uint64_t bit_position) const
+{
+  using enum BlockType;
+
+  auto smallest_type{ DYNAMIC };
+  auto smallest_size{ get_block_size(DYNAMIC, bit_position) };
+
+  if (auto size{ get_block_size(FIXED, bit_position) }; size < smallest_size) {
+    smallest_type = FIXED;
+    smallest_size = size;
+  }
+  // Blocks can be longer than a stored block can hold, but then they are mostly back-references, and no symbol takes
+  // more than 31 bits with the fixed codes. With at most `LzssSymbolBuffer::CAPACITY` symbols, that always beats
+  // storing the bytes.
+  if (is_storable_ && get_block_size(STORED, bit_position) < smallest_size) {
+    smallest_type = STORED;
+  }
+
+  return smallest_type;
+}
+
+uint64_t BlockEncoder::get_symbols_size(const prefix_codes::CodeLengthTable &ll_code_lengths,
+  const prefix_codes::CodeLengthTable &distance_code_lengths) const
+{
+  uint64_t size{ 0 };
+
+  // Literals, lengths and the end of block code.
+  for (unsigned int code{ 0 }; code <= MAX_LL_CODE; code++) {
+    size += uint64_t{ ll_freqs_[code] } * ll_code_lengths[code];
+  }
+  for (unsigned int code{ END_OF_BLOCK + 1 }; code <= MAX_LL_CODE; code++) {
+    size += uint64_t{ ll_freqs_[code] } * lzss::code_tables::get_length_entry_by_code(code).extra_bits;
+  }
+
+  for (unsigned int code{ 0 }; code <= MAX_DISTANCE_CODE; code++) {
+    size += uint64_t{ distance_freqs_[code] }
+            * (distance_code_lengths[code] + lzss::code_tables::get_distance_entry_by_code(code).extra_bits);
+  }
+
+  return size;
+}
+
+template <typename BitSink>
+void BlockEncoder::write_block(BitSink &bit_sink, BlockType block_type, bool is_last_block) const
+{
+  bit_sink.put_single_bit(is_last_block);
+  bit_sink.put_bits(static_cast<unsigned int>(block_type), 2);
+
+  switch (block_type) {
+    using enum BlockType;
+
+    case STORED:
+      assert(is_storable_ && "block can't be stored");
+      write_stored_bytes(bit_sink, input_);
+      break;
+    case FIXED:
+      write_symbols(bit_sink, fixed_code_tables::EMISSION_TABLE);
+      break;
+    case DYNAMIC:
+      write_dynamic_header(bit_sink);
+      write_symbols(bit_sink, emission_table_);
+      break;
+  }
+}
+
+template <typename BitSink>
+void BlockEncoder::write_stored_block(BitSink &bit_sink, std::string_view input, bool is_last_block)
+{
+  assert(input.length() <= MAX_STORED_BLOCK_LENGTH && "block can't be stored");
+
+  bit_sink.put_single_bit(is_last_block);
+  bit_sink.put_bits(static_cast<unsigned int>(BlockType::STORED), 2);
+  write_stored_bytes(bit_sink, input);
+}
+
+template <typename BitSink>
+void BlockEncoder::write_stored_bytes(BitSink &bit_sink, std::string_view input)
+{
+  bit_sink.pad_to_byte();
+
+  bit_sink.put_bits(input.length(), 16);
+  bit_sink.put_bits(~input.length(), 16);
+
+  for (auto byte : input) {
+    bit_sink.put_bits(byte, 8);
+  }
+}
+
+template <typename BitSink>
+void BlockEncoder::write_dynamic_header(BitSink &bit_sink) const
+{
+  // Write the number of codes of each type.
+
+  bit_sink.put_bits(num_ll_codes_ - 257, 5);
+  bit_sink.put_bits(num_distance_codes_ - 1, 5);
+  bit_sink.put_bits(num_cl_codes_ - 4, 4);
+
+  // Write the CL code length table.
+
+  for (unsigned int i{ 0 }; i < num_cl_codes_; i++) {
+    bit_sink.put_bits(cl_code_length_buffer_[i], 3);
+  }
+
+  // Write the length/literal and distance code length tables.
+
+  const auto &cl_code_lengths{ cl_encoder_.get_code_length_table() };
+
+  for (unsigned int i{ 0 }; i < rle_output_size_; i++) {
+    const auto &symbol{ rle_output_[i] };
+    auto bits{ reversed_cl_codes_[symbol.code] };
+    auto num_bits{ cl_code_lengths[symbol.code] };
+
+    // Repeat counts go right after the repeat code.
+    if (symbol.code == 16) {
+      bits |= (symbol.repeat_count - 3) << num_bits;
+      num_bits += 2;
+    } else if (symbol.code == 17) {
+      bits |= (symbol.repeat_count - 3) << num_bits;
+      num_bits += 3;
+    } else if (symbol.code == 18) {
+      bits |= (symbol.repeat_count - 11) << num_bits;
+      num_bits += 7;
+    }
+
+    bit_sink.put_bits(bits, num_bits);
+  }
+}
+
+template <typename BitSink>
+void BlockEncoder::write_symbols(BitSink &bit_sink, const EmissionTable &emission_table) const
+{
+  // Every symbol goes out as a single write, with any extra bits already attached to its codes. A length and a
+  // distance together come to at most 48 bits, so a whole back-reference fits in one write.
+  for (const auto &symbol : *symbol_buffer_) {
+    if (symbol.is_literal()) {
+      auto [bits, num_bits]{ emission_table.get_ll_entry(symbol.get_literal()) };
+      bit_sink.put_bits(bits, num_bits);
+      continue;
+    }
+
+    auto [length_bits, num_length_bits]{ emission_table.get_length_entry(symbol.get_length()) };
+
+    const auto &distance_entry{ lzss::code_tables::get_distance_entry_by_distance(symbol.get_distance()) };
+    auto [distance_bits, num_distance_bits]{ emission_table.get_distance_entry(distance_entry.code) };
+    distance_bits |= (symbol.get_distance() - distance_entry.lower_bound) << num_distance_bits;
+    num_distance_bits += distance_entry.extra_bits;
+
+    bit_sink.put_bits(
+      length_bits | (uint64_t{ distance_bits } << num_length_bits), num_length_bits + num_distance_bits);
+  }
+
+  auto [bits, num_bits]{ emission_table.get_ll_entry(END_OF_BLOCK) };
+  bit_sink.put_bits(bits, num_bits);
+}
+
+void BlockEncoder::compute_dynamic_codes()
+{
+  // The symbol buffer counted the symbols as they were added, apart from the end of block code.
+
+  ll_freqs_ = symbol_buffer_->get_ll_frequencies();
+  distance_freqs_ = symbol_buffer_->get_distance_frequencies();
+  ll_freqs_[END_OF_BLOCK]++;
+
+  // Compute separate prefix codes for length/literal symbols and distance symbols.
+
+  ll_encoder_.encode(ll_freqs_);
+  distance_encoder_.encode(distance_freqs_);
+
+  const auto &ll_code_lengths{ ll_encoder_.get_code_length_table() };
+  const auto &distance_code_lengths{ distance_encoder_.get_code_length_table() };
+
+  num_ll_codes_ = 0;
+  for (unsigned int code{ 0 }; code <= MAX_LL_CODE; code++) {
+    if (ll_code_lengths[code] > 0) {
+      num_ll_codes_ = code + 1;
+    }
+  }
+
+  // Block type 2 insists on having at least 1 distance code, even if it is unused.
+  num_distance_codes_ = 1;
+  for (unsigned int code{ 0 }; code <= MAX_DISTANCE_CODE; code++) {
+    if (distance_code_lengths[code] > 0) {
+      num_distance_codes_ = code + 1;
+    }
+  }
+
+  emission_table_.initialize(ll_code_lengths, distance_code_lengths);
+
+  run_length_encode_code_lengths();
+
+  // Compute the frequency of each code length symbol, and the CL codes from them.
+
+  prefix_codes::FrequencyTable cl_freqs{};
+  for (unsigned int i{ 0 }; i < rle_output_size_; i++) {
+    cl_freqs[rle_output_[i].code]++;
+  }
+
+  cl_encoder_.encode(cl_freqs);
+
+  // Put the CL code lengths into a contiguous buffer. The codes go into the buffer in a weird order.
+
+  const std::array<unsigned int, NUM_CL_CODES> CL_CODE_LENGTH_ORDER{
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+  };
+  const auto &cl_code_lengths{ cl_encoder_.get_code_length_table() };
+  const auto &cl_codes{ cl_encoder_.get_code_table() };
+
+  num_cl_codes_ = 4;
+  for (unsigned int i{ 0 }; i < NUM_CL_CODES; i++) {
+    cl_code_length_buffer_[i] = cl_code_lengths[CL_CODE_LENGTH_ORDER[i]];
+    if (cl_code_length_buffer_[i] > 0) {
+      num_cl_codes_ = std::max(num_cl_codes_, i + 1);
+    }
+  }
+
+  for (unsigned int code{ 0 }; code < NUM_CL_CODES; code++) {
+    reversed_cl_codes_[code] = 0;
+    if (cl_code_lengths[code] > 0) {
+      reversed_cl_codes_[code] = bit_io::reverse_bits(cl_codes[code], cl_code_lengths[code]);
+    }
+  }
+
+  // The header takes the three code counts, the CL code length table, then the CL codes with their repeat counts.
+
+  dynamic_header_size_ = 5 + 5 + 4 + 3 * num_cl_codes_;
+  for (unsigned int i{ 0 }; i < rle_output_size_; i++) {
+    const auto &symbol{ rle_output_[i] };
+    dynamic_header_size_ += cl_code_lengths[symbol.code];
+    if (symbol.code == 16) {
+      dynamic_header_size_ += 2;
+    } else if (symbol.code == 17) {
+      dynamic_header_size_ += 3;
+    } else if (symbol.code == 18) {
+      dynamic_header_size_ += 7;
+    }
+  }
+}
+
+void BlockEncoder::run_length_encode_code_lengths()
+{
+  // Put all the length/literal and distance code lengths into a contiguous buffer.
+
+  const auto &ll_code_lengths{ ll_encoder_.get_code_length_table() };
+  const auto &distance_code_lengths{ distance_encoder_.get_code_length_table() };
+
+  std::array<unsigned int, MAX_LL_CODE + 1 + MAX_DISTANCE_CODE + 1> code_length_buffer{};
+  std::copy_n(ll_code_lengths.begin(), num_ll_codes_, code_length_buffer.begin());
+  std::copy_n(distance_code_lengths.begin(), num_distance_codes_, code_length_buffer.begin() + num_ll_codes_);
+  unsigned int code_length_buffer_size{ num_ll_codes_ + num_distance_codes_ };
+
+  rle_output_size_ = 0;
+
+  for (unsigned int i{ 0 }; i < code_length_buffer_size;) {
+    auto length{ code_length_buffer[i] };
+
+    unsigned int run_length{ 1 };
+    while (i + run_length < code_length_buffer_size && code_length_buffer[i + run_length] == length) {
+      run_length++;
+    }
+    i += run_length;
+
+    rle_output_[rle_output_size_++] = { length };
+    auto repeat_count{ run_length - 1 };
+
+    auto max_repeat_count{ length == 0 ? 138U : 6U };
+    while (repeat_count >= max_repeat_count) {
+      rle_output_[rle_output_size_++] = { length == 0 ? 18U : 16U, max_repeat_count };
+      repeat_count -= max_repeat_count;
+    }
+
+    if (repeat_count >= 3) {
+      if (length == 0) {
+        rle_output_[rle_output_size_++] = { repeat_count <= 10 ? 17U : 18U, repeat_count };
+      } else {
+        rle_output_[rle_output_size_++] = { 16, repeat_count };
+      }
+    } else {
+      for (unsigned int j{ 0 }; j < repeat_count; j++) {
+        rle_output_[rle_output_size_++] = { length };
+      }
+    }
+  }
+}
+
+// Blocks are written to a `BitWriter`. The `BitCounter` instantiation is there for the tests, which count the bits
+// written to check `get_block_size`.
+template void BlockEncoder::write_block(bit_io::BitWriter &, BlockType, bool) const;
+template void BlockEncoder::write_block(bit_io::BitCounter &, BlockType, bool) const;
+template void BlockEncoder::write_stored_block(bit_io::BitWriter &, std::string_view, bool);
+
+}  // namespace gzip
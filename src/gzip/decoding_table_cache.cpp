@@ -0,0 +1,65 @@
+#include "gzip/decoding_table_cache.hpp"
+#include "prefix_codes/decoding_table.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace gzip {
+
+DecodingTableCache::DecodingTableCache() : entries_(NUM_ENTRIES) {}
+
+const DecodingTableCache::Tables &DecodingTableCache::get_tables(const prefix_codes::CodeLengthTable &ll_code_lengths,
+  const prefix_codes::CodeLengthTable &distance_code_lengths)
+{
+  auto hash{ hash_code_lengths(ll_code_lengths, distance_code_lengths) };
+  num_lookups_++;
+
+  for (auto &entry : entries_) {
+    if (entry.valid && entry.hash == hash && entry.ll_code_lengths == ll_code_lengths
+        && entry.distance_code_lengths == distance_code_lengths) {
+      hits_++;
+      entry.last_used = num_lookups_;
+      return entry.tables;
+    }
+  }
+
+  misses_++;
+
+  // Replace the least recently used entry. Invalid entries have never been used, so they go first.
+  auto &entry{ *std::min_element(entries_.begin(), entries_.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.last_used < rhs.last_used;
+  }) };
+
+  // Building the tables can throw, so the entry is only marked valid once they are done.
+  entry.valid = false;
+  entry.tables.ll_table.build(ll_code_lengths);
+  entry.tables.ll_multi_literal_table.build(entry.tables.ll_table);
+  entry.tables.distance_table.build(distance_code_lengths);
+
+  entry.valid = true;
+  entry.hash = hash;
+  entry.last_used = num_lookups_;
+  entry.ll_code_lengths = ll_code_lengths;
+  entry.distance_code_lengths = distance_code_lengths;
+
+  return entry.tables;
+}
+
+uint64_t DecodingTableCache::hash_code_lengths(const prefix_codes::CodeLengthTable &ll_code_lengths,
+  const prefix_codes::CodeLengthTable &distance_code_lengths)
+{
+  // FNV-1a over both tables. Code lengths fit in a byte, so each one is hashed as a single byte.
+  const uint64_t FNV_OFFSET_BASIS{ 0xcbf29ce484222325 };
+  const uint64_t FNV_PRIME{ 0x100000001b3 };
+
+  uint64_t hash{ FNV_OFFSET_BASIS };
+  for (const auto *code_lengths : { &ll_code_lengths, &distance_code_lengths }) {
+    for (auto length : *code_lengths) {
+      hash = (hash ^ length) * FNV_PRIME;
+    }
+  }
+  return hash;
+}
+
+}  // namespace gzip
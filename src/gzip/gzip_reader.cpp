@@ -1,26 +1,60 @@
 #include "gzip/gzip_reader.hpp"
+#include "gzip/decoding_table_cache.hpp"
+#include "gzip/fixed_code_tables.hpp"
+#include "gzip/stream_format.hpp"
 #include "lzss/lzss_code_tables.hpp"
+#include "prefix_codes/decoding_table.hpp"
 #include "prefix_codes/prefix_code_decoder.hpp"
 #include "prefix_codes/prefix_code_types.hpp"
 
+#include <algorithm>
 #include <array>
-#include <cassert>
-#include <deque>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
 #include <string>
 
 namespace gzip {
 
-GzipReader::GzipReader(std::istream &input, std::ostream &output)
-  : input_{ input }, output_{ output }, bit_reader_{ input }
+namespace {
+
+  // The fixed codes, and the counts in a dynamic block header, allow for length/literal codes 286 and 287 and distance
+  // codes 30 and 31, but they never appear in valid data.
+  const unsigned int MAX_LL_CODE{ 285 };
+  const unsigned int MAX_DISTANCE_CODE{ 29 };
+
+}  // namespace
+
+GzipReader::GzipReader(bit_io::ByteSource &input,
+  bit_io::ByteSink &output,
+  StreamFormat format,
+  std::span<const std::byte> dictionary)
+  : bit_reader_{ input }, output_{ output }, format_{ format }, dictionary_{ dictionary }, window_(WINDOW_SIZE)
 {
-  compute_fixed_code_tables();
+  if (!dictionary.empty() && format == StreamFormat::GZIP) {
+    throw std::invalid_argument("A preset dictionary can't be used in a gzip stream.");
+  }
 }
 
 void GzipReader::read()
 {
-  read_header();
+  switch (format_) {
+    case StreamFormat::GZIP:
+      read_header();
+      break;
+    case StreamFormat::ZLIB:
+      read_zlib_header();
+      break;
+    case StreamFormat::RAW:
+      // Nothing says whether a raw stream used a dictionary, so one is assumed if given.
+      put_dictionary();
+      break;
+  }
+
   read_deflate_bit_stream();
   read_footer();
+  flush_window();
 }
 
 void GzipReader::read_header()
@@ -43,6 +77,41 @@ void GzipReader::read_header()
   bit_reader_.get_bits(8);
 }
 
+void GzipReader::read_zlib_header()
+{
+  const unsigned int COMPRESSION_METHOD{ 0x08 };
+  const unsigned int MAX_WINDOW_INFO{ 7 };
+  const unsigned int PRESET_DICTIONARY_FLAG{ 0x20 };
+
+  auto method_and_info{ bit_reader_.get_bits(8) };
+  auto flags{ bit_reader_.get_bits(8) };
+
+  if ((method_and_info * 256 + flags) % 31 != 0) {
+    throw GzipReaderError("Invalid zlib stream.");
+  }
+  if ((method_and_info & 0x0f) != COMPRESSION_METHOD || (method_and_info >> 4) > MAX_WINDOW_INFO) {
+    throw GzipReaderError("Invalid compression method.");
+  }
+
+  if ((flags & PRESET_DICTIONARY_FLAG) == 0) {
+    return;
+  }
+
+  // The dictionary is identified by its Adler-32 checksum, which is big-endian.
+  uint32_t dictionary_id{ 0 };
+  for (unsigned int i{ 0 }; i < 4; i++) {
+    dictionary_id = (dictionary_id << 8) | static_cast<uint32_t>(bit_reader_.get_bits(8));
+  }
+
+  if (dictionary_.empty()) {
+    throw GzipReaderError("Stream needs a preset dictionary.");
+  }
+  if (adler32(dictionary_) != dictionary_id) {
+    throw GzipReaderError("Wrong preset dictionary.");
+  }
+  put_dictionary();
+}
+
 void GzipReader::read_deflate_bit_stream()
 {
   while (true) {
@@ -52,12 +121,15 @@ void GzipReader::read_deflate_bit_stream()
       break;
     }
 
-    // XXX: Read block of appropriate type based on value of `block_type`.
-
-    // XXX: Sanity check. Remove later.
-    assert(block_type == 2);
-
-    read_block_type_2();
+    if (block_type == 0) {
+      read_block_type_0();
+    } else if (block_type == 1) {
+      read_block_type_1();
+    } else if (block_type == 2) {
+      read_block_type_2();
+    } else {
+      throw GzipReaderError("Invalid block type " + std::to_string(block_type) + ".");
+    }
 
     if (is_last_block) {
       break;
@@ -77,26 +149,27 @@ void GzipReader::read_block_type_0()
   }
 
   for (unsigned int i{ 0 }; i < input_size; i++) {
-    output_.put(bit_reader_.get_bits(8));
+    put_literal(bit_reader_.get_bits(8));
   }
 }
 
 void GzipReader::read_block_type_1()
 {
+  prefix_codes::PrefixCodeDecoder ll_code_decoder{ bit_reader_, fixed_code_tables::LL_DECODING_TABLE };
+  prefix_codes::PrefixCodeDecoder distance_code_decoder{ bit_reader_, fixed_code_tables::DISTANCE_DECODING_TABLE };
+
   while (true) {
-    auto ll_code{ fixed_ll_code_decoder_.decode_symbol() };
+    auto ll_code{ ll_code_decoder.decode_symbol() };
     if (ll_code == 256) {
       break;
     }
 
     if (ll_code < 256) {
-      output_.put(ll_code);
-
-      history_.push_back(ll_code);
-      if (history_.size() > 32768) {
-        history_.pop_front();
-      }
+      put_literal(ll_code);
     } else {
+      if (ll_code > MAX_LL_CODE) {
+        throw GzipReaderError("Invalid length/literal code " + std::to_string(ll_code) + ".");
+      }
       auto ll_entry{ lzss::code_tables::get_length_entry_by_code(ll_code) };
 
       unsigned int length{ ll_entry.lower_bound };
@@ -104,7 +177,10 @@ void GzipReader::read_block_type_1()
         length += bit_reader_.get_bits(ll_entry.extra_bits);
       }
 
-      auto distance_code{ fixed_distance_code_decoder_.decode_symbol() };
+      auto distance_code{ distance_code_decoder.decode_symbol() };
+      if (distance_code > MAX_DISTANCE_CODE) {
+        throw GzipReaderError("Invalid distance code " + std::to_string(distance_code) + ".");
+      }
       auto distance_entry{ lzss::code_tables::get_distance_entry_by_code(distance_code) };
 
       unsigned int distance{ distance_entry.lower_bound };
@@ -112,20 +188,7 @@ void GzipReader::read_block_type_1()
         distance += bit_reader_.get_bits(distance_entry.extra_bits);
       }
 
-      if (distance > history_.size()) {
-        throw GzipReaderError("Got invalid back-reference: (" + std::to_string(length) + ", " + std::to_string(distance)
-                              + "), history size is " + std::to_string(history_.size()));
-      }
-
-      for (unsigned int i{ 0 }; i < length; i++) {
-        unsigned int symbol{ history_.at(history_.size() - distance) };
-        output_.put(symbol);
-
-        history_.push_back(symbol);
-        if (history_.size() > 32768) {
-          history_.pop_front();
-        }
-      }
+      put_back_reference(length, distance);
     }
   }
 }
@@ -145,33 +208,41 @@ void GzipReader::read_block_type_2()
   for (unsigned int i{ 0 }; i < num_cl_codes; i++) {
     auto code{ CL_CODE_LENGTH_ORDER[i] };
     auto length{ bit_reader_.get_bits(3) };
-    cl_code_lengths.insert({ code, length });
+    cl_code_lengths[code] = length;
   }
 
-  prefix_codes::PrefixCodeDecoder cl_code_decoder{ bit_reader_, cl_code_lengths };
-  cl_code_decoder.initialize();
+  if (cl_code_lengths != cl_code_lengths_) {
+    cl_decoding_table_.build(cl_code_lengths);
+    cl_code_lengths_ = cl_code_lengths;
+  }
+  prefix_codes::PrefixCodeDecoder cl_code_decoder{ bit_reader_, cl_decoding_table_ };
 
   prefix_codes::CodeLengthTable ll_code_lengths{};
   prefix_codes::CodeLengthTable distance_code_lengths{};
 
+  // The two code length tables are run-length encoded as one sequence, so repeats can run from one into the other.
+  auto set_code_length = [&](unsigned int index, unsigned int length) {
+    if (index < num_ll_codes) {
+      ll_code_lengths[index] = length;
+    } else {
+      distance_code_lengths[index - num_ll_codes] = length;
+    }
+  };
+
   unsigned int codes_read{ 0 };
-  unsigned int last_code;
+  unsigned int last_code{ 0 };
 
   while (codes_read < num_ll_codes + num_distance_codes) {
     unsigned int code{ cl_code_decoder.decode_symbol() };
 
     if (code <= 15) {
-      if (codes_read < num_ll_codes) {
-        ll_code_lengths.insert({ codes_read, code });
-      } else {
-        distance_code_lengths.insert({ codes_read - num_ll_codes, code });
-      }
+      set_code_length(codes_read, code);
       codes_read++;
       last_code = code;
       continue;
     }
 
-    if (codes_read == 0) {
+    if (code == 16 && codes_read == 0) {
       throw GzipReaderError("Got repeat code " + std::to_string(code) + " as first symbol in LL/distance code table.");
     }
 
@@ -184,35 +255,49 @@ void GzipReader::read_block_type_2()
       repeat_count = bit_reader_.get_bits(7) + 11;
     }
 
+    if (codes_read + repeat_count > num_ll_codes + num_distance_codes) {
+      throw GzipReaderError("Repeat code " + std::to_string(code) + " runs past the end of the LL/distance code table.");
+    }
+
+    // Code 16 repeats the last code length, while 17 and 18 repeat zeros.
+    if (code > 16) {
+      last_code = 0;
+    }
+
     for (unsigned int i{ 0 }; i < repeat_count; i++) {
-      if (codes_read < num_ll_codes) {
-        ll_code_lengths.insert({ codes_read, last_code });
-      } else {
-        distance_code_lengths.insert({ codes_read - num_ll_codes, last_code });
-      }
+      set_code_length(codes_read, last_code);
       codes_read++;
     }
   }
 
-  prefix_codes::PrefixCodeDecoder ll_code_decoder{ bit_reader_, ll_code_lengths };
-  ll_code_decoder.initialize();
-  prefix_codes::PrefixCodeDecoder distance_code_decoder{ bit_reader_, distance_code_lengths };
-  distance_code_decoder.initialize();
+  const auto &tables{ decoding_table_cache_.get_tables(ll_code_lengths, distance_code_lengths) };
+
+  // Literal-heavy blocks are common, so look up runs of short literals all at once.
+  prefix_codes::PrefixCodeDecoder ll_code_decoder{ bit_reader_, tables.ll_table, tables.ll_multi_literal_table };
+  prefix_codes::PrefixCodeDecoder distance_code_decoder{ bit_reader_, tables.distance_table };
+
+  prefix_codes::PrefixCodeDecoder::SymbolBuffer ll_codes{};
 
   while (true) {
-    auto ll_code{ ll_code_decoder.decode_symbol() };
+    auto num_ll_codes_decoded{ ll_code_decoder.decode_symbols(ll_codes) };
+    if (num_ll_codes_decoded > 1) {
+      for (unsigned int i{ 0 }; i < num_ll_codes_decoded; i++) {
+        put_literal(ll_codes[i]);
+      }
+      continue;
+    }
+
+    auto ll_code{ ll_codes[0] };
     if (ll_code == 256) {
       break;
     }
 
     if (ll_code < 256) {
-      output_.put(ll_code);
-
-      history_.push_back(ll_code);
-      if (history_.size() > 32768) {
-        history_.pop_front();
-      }
+      put_literal(ll_code);
     } else {
+      if (ll_code > MAX_LL_CODE) {
+        throw GzipReaderError("Invalid length/literal code " + std::to_string(ll_code) + ".");
+      }
       auto ll_entry{ lzss::code_tables::get_length_entry_by_code(ll_code) };
 
       unsigned int length{ ll_entry.lower_bound };
@@ -221,6 +306,9 @@ void GzipReader::read_block_type_2()
       }
 
       auto distance_code{ distance_code_decoder.decode_symbol() };
+      if (distance_code > MAX_DISTANCE_CODE) {
+        throw GzipReaderError("Invalid distance code " + std::to_string(distance_code) + ".");
+      }
       auto distance_entry{ lzss::code_tables::get_distance_entry_by_code(distance_code) };
 
       unsigned int distance{ distance_entry.lower_bound };
@@ -228,45 +316,62 @@ void GzipReader::read_block_type_2()
         distance += bit_reader_.get_bits(distance_entry.extra_bits);
       }
 
-      if (distance > history_.size()) {
-        throw GzipReaderError("Got invalid back-reference: (" + std::to_string(length) + ", " + std::to_string(distance)
-                              + "), history size is " + std::to_string(history_.size()));
-      }
-
-      for (unsigned int i{ 0 }; i < length; i++) {
-        unsigned int symbol{ history_.at(history_.size() - distance) };
-        output_.put(symbol);
-
-        history_.push_back(symbol);
-        if (history_.size() > 32768) {
-          history_.pop_front();
-        }
-      }
+      put_back_reference(length, distance);
     }
   }
 }
 
-void GzipReader::compute_fixed_code_tables()
+void GzipReader::put_literal(unsigned int value)
 {
-  for (unsigned int code{ 0 }; code <= 143; code++) {
-    fixed_ll_code_lengths_.insert({ code, 8 });
+  if (window_pos_ == window_.size()) {
+    flush_window();
   }
-  for (unsigned int code{ 144 }; code <= 255; code++) {
-    fixed_ll_code_lengths_.insert({ code, 9 });
+
+  window_[window_pos_++] = static_cast<std::byte>(value);
+  output_size_++;
+}
+
+void GzipReader::put_back_reference(unsigned int length, unsigned int distance)
+{
+  auto history_size{ std::min<uint64_t>(output_size_ + dictionary_size_, HISTORY_SIZE) };
+  if (distance > history_size) {
+    throw GzipReaderError("Got invalid back-reference: (" + std::to_string(length) + ", " + std::to_string(distance)
+                          + "), history size is " + std::to_string(history_size));
   }
-  for (unsigned int code{ 256 }; code <= 279; code++) {
-    fixed_ll_code_lengths_.insert({ code, 7 });
+
+  if (window_pos_ + length > window_.size()) {
+    flush_window();
   }
-  for (unsigned int code{ 280 }; code <= 287; code++) {
-    fixed_ll_code_lengths_.insert({ code, 8 });
+
+  // The source and destination can overlap, so this has to go byte by byte.
+  for (unsigned int i{ 0 }; i < length; i++) {
+    window_[window_pos_ + i] = window_[window_pos_ - distance + i];
   }
+  window_pos_ += length;
+  output_size_ += length;
+}
 
-  for (unsigned int code{ 0 }; code <= 29; code++) {
-    fixed_distance_code_lengths_.insert({ code, 5 });
+void GzipReader::flush_window()
+{
+  output_.write(std::span{ window_ }.subspan(flushed_pos_, window_pos_ - flushed_pos_));
+
+  if (window_pos_ > HISTORY_SIZE) {
+    std::copy(window_.begin() + (window_pos_ - HISTORY_SIZE), window_.begin() + window_pos_, window_.begin());
+    window_pos_ = HISTORY_SIZE;
   }
+  flushed_pos_ = window_pos_;
+}
 
-  fixed_ll_code_decoder_.initialize();
-  fixed_distance_code_decoder_.initialize();
+void GzipReader::put_dictionary()
+{
+  // The dictionary only serves as history, so it goes in the window without being written out. Only the last
+  // `HISTORY_SIZE` bytes of it can be referred back to.
+  auto dictionary{ dictionary_.last(std::min(dictionary_.size(), HISTORY_SIZE)) };
+
+  std::copy(dictionary.begin(), dictionary.end(), window_.begin());
+  window_pos_ = dictionary.size();
+  flushed_pos_ = dictionary.size();
+  dictionary_size_ = dictionary.size();
 }
 
 }  // namespace gzip
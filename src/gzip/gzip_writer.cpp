@@ -1,22 +1,63 @@
 #include "gzip/gzip_writer.hpp"
-#include "lzss/lzss_symbol.hpp"
-#include "prefix_codes/prefix_code_encoder.hpp"
-
-#include <array>
-#include <cassert>
+#include "gzip/block_encoder.hpp"
+#include "gzip/stream_format.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 
 namespace gzip {
 
-GzipWriter::GzipWriter(std::istream &input, std::ostream &output)
-  : input_{ input }, output_{ output }, bit_writer_{ output }
-{}
+namespace {
+
+  unsigned int get_zlib_level(const lzss::LzssEncoderConfig &config)
+  {
+    // 0 is the fastest compression, 1 fast, 2 the default and 3 the slowest.
+    if (config.strategy != lzss::Strategy::DEFAULT || config.match_finder_type == lzss::MatchFinderType::HASH_TABLE) {
+      return 0;
+    }
+    if (config.max_lazy_length == 0 && config.optimal_parse_iterations == 0) {
+      return 1;
+    }
+    return config.match_finder_type == lzss::MatchFinderType::BINARY_TREE ? 3 : 2;
+  }
+
+}  // namespace
+
+GzipWriter::GzipWriter(bit_io::ByteSource &input,
+  bit_io::ByteSink &output,
+  const lzss::LzssEncoderConfig &config,
+  StreamFormat format,
+  std::span<const std::byte> dictionary)
+  : format_{ format }, zlib_level_{ get_zlib_level(config) }, dictionary_{ dictionary }, input_{ input },
+    bit_writer_{ output }, lzss_encoder_{ config }
+{
+  if (!dictionary.empty()) {
+    if (format == StreamFormat::GZIP) {
+      throw std::invalid_argument("A preset dictionary can't be used in a gzip stream.");
+    }
+    lzss_encoder_.set_dictionary({ reinterpret_cast<const char *>(dictionary.data()), dictionary.size() });
+  }
+}
 
 void GzipWriter::write()
 {
-  write_header();
+  switch (format_) {
+    case StreamFormat::GZIP:
+      write_header();
+      break;
+    case StreamFormat::ZLIB:
+      write_zlib_header();
+      break;
+    case StreamFormat::RAW:
+      break;
+  }
+
   write_deflate_bit_stream();
   write_footer();
 }
@@ -41,371 +82,160 @@ void GzipWriter::write_header()
   bit_writer_.put_bits(OPERATING_SYSTEM, 8);
 }
 
-void GzipWriter::write_deflate_bit_stream()
+void GzipWriter::write_zlib_header()
 {
-  while (true) {
-    auto input_buffer{ read_input_chunk() };
-    input_size_ += input_buffer.length();
-    bool is_last_block{ input_.eof() };
+  // Deflate with a 32K window.
+  const unsigned int COMPRESSION_METHOD_AND_INFO{ 0x78 };
+  const unsigned int PRESET_DICTIONARY_FLAG{ 0x20 };
 
-    // XXX: Strategically choose block type.
-    write_block_type_2(input_buffer, is_last_block);
-
-    if (is_last_block) {
-      break;
-    }
+  auto flags{ zlib_level_ << 6 };
+  if (!dictionary_.empty()) {
+    flags |= PRESET_DICTIONARY_FLAG;
   }
-}
+  // The check bits make the first two bytes, read as a big-endian number, a multiple of 31.
+  flags |= (31 - (COMPRESSION_METHOD_AND_INFO * 256 + flags) % 31) % 31;
 
-void GzipWriter::write_footer()
-{
-  bit_writer_.pad_to_byte();
-  bit_writer_.put_bits(0, 32);  // XXX: Write CRC32.
-  bit_writer_.put_bits(input_size_, 32);
-  bit_writer_.finish();
-}
-
-std::string GzipWriter::read_input_chunk()
-{
-  std::string input_buffer{};
-  char byte;
+  bit_writer_.put_bits(COMPRESSION_METHOD_AND_INFO, 8);
+  bit_writer_.put_bits(flags, 8);
 
-  for (unsigned int i{ 0 }; i < INPUT_CHUNK_SIZE; i++) {
-    if (!input_.get(byte)) {
-      break;
-    }
-    input_buffer += byte;
+  if (!dictionary_.empty()) {
+    put_big_endian(adler32(dictionary_));
   }
-
-  return input_buffer;
 }
 
-void GzipWriter::write_block_type_0(std::string_view input_buffer, bool is_last_block)
-{
-  const unsigned int MAX_BLOCK_LENGTH{ 65535 };
-  const unsigned int BLOCK_TYPE{ 0 };
-
-  assert(input_buffer.length() <= MAX_BLOCK_LENGTH);
-
-  bit_writer_.put_single_bit(is_last_block);
-  bit_writer_.put_bits(BLOCK_TYPE, 2);
-  bit_writer_.pad_to_byte();
-
-  bit_writer_.put_bits(input_buffer.length(), 16);
-  bit_writer_.put_bits(~input_buffer.length(), 16);
-
-  for (auto byte : input_buffer) {
-    bit_writer_.put_bits(byte, 8);
-  }
-}
-
-void GzipWriter::write_block_type_1(std::string_view input_buffer, bool is_last_block)
+void GzipWriter::write_deflate_bit_stream()
 {
-  const unsigned int BLOCK_TYPE{ 1 };
-  bit_writer_.put_single_bit(is_last_block);
-  bit_writer_.put_bits(BLOCK_TYPE, 2);
-
-  lzss_encoder_.encode(input_buffer);
-
-  auto symbol_list{ lzss_encoder_.get_symbol_list() };
-  symbol_list.add(lzss::END_OF_BLOCK_MARKER);
-
-  for (const auto &symbol : symbol_list) {
-    using enum lzss::LzssSymbolType;
+  bool start_new_block{ true };
 
-    switch (symbol.get_type()) {
-      case LITERAL:
-      case LENGTH: {
-        auto [prefix_code, num_bits]{ fixed_code_table_.get_length_literal_entry(symbol.get_code()) };
-        bit_writer_.put_bits(prefix_code, num_bits, false);
-        break;
-      }
-      case DISTANCE: {
-        auto [prefix_code, num_bits]{ fixed_code_table_.get_distance_entry(symbol.get_code()) };
-        bit_writer_.put_bits(prefix_code, num_bits, false);
-        break;
+  while (true) {
+    auto input_buffer{ read_input_chunk() };
+    input_size_ += input_buffer.length();
+    if (format_ == StreamFormat::ZLIB) {
+      input_adler32_ = update_adler32(input_adler32_, std::as_bytes(std::span{ input_buffer }));
+    }
+    bool is_last_chunk{ at_end_of_input() };
+
+    // The encoder stops early whenever the symbol buffer fills up, or the symbols change enough to be worth new codes,
+    // which ends the block there. Otherwise the block carries on into the next chunk.
+    do {
+      auto num_bytes{ lzss_encoder_.encode(input_buffer, start_new_block) };
+      if (is_block_storable_) {
+        is_block_storable_ = block_input_.length() + num_bytes <= BlockEncoder::MAX_STORED_BLOCK_LENGTH;
+        if (is_block_storable_) {
+          block_input_.append(input_buffer.substr(0, num_bytes));
+        } else {
+          block_input_.clear();
+        }
       }
-    }
+      input_buffer.remove_prefix(num_bytes);
 
-    if (symbol.get_type() == LITERAL) {
-      continue;
-    }
+      bool is_last_block{ is_last_chunk && input_buffer.empty() };
+      start_new_block = is_last_block || lzss_encoder_.get_symbol_buffer().should_end_block();
+      if (start_new_block) {
+        write_block(is_last_block);
+      }
+    } while (!input_buffer.empty());
 
-    auto extra_bits{ symbol.get_extra_bits() };
-    if (extra_bits > 0) {
-      auto offset{ symbol.get_offset() };
-      bit_writer_.put_bits(offset, extra_bits);
+    if (is_last_chunk) {
+      break;
     }
   }
 }
 
-void GzipWriter::write_block_type_2(std::string_view input_buffer, bool is_last_block)
+void GzipWriter::write_block(bool is_last_block)
 {
-  const unsigned int BLOCK_TYPE{ 2 };
-  bit_writer_.put_single_bit(is_last_block);
-  bit_writer_.put_bits(BLOCK_TYPE, 2);
-
-  lzss_encoder_.encode(input_buffer);
-
-  auto symbol_list{ lzss_encoder_.get_symbol_list() };
-  symbol_list.add(lzss::END_OF_BLOCK_MARKER);
-
-  // Divide the input symbols into length/literal symbols and distance symbols.
+  block_encoder_.prepare(block_input_, lzss_encoder_.get_symbol_buffer(), is_block_storable_);
 
-  std::vector<unsigned int> input_ll_codes{};
-  std::vector<unsigned int> input_distance_codes{};
-  for (auto symbol : symbol_list) {
-    using enum lzss::LzssSymbolType;
+  // Whichever block type comes out smallest. Input that doesn't compress goes into stored blocks, so it grows by a few
+  // bytes at most. A held back stored block ends on a byte boundary, so this one would start on one.
+  auto bit_position{ stored_input_.empty() ? bit_writer_.get_bit_count() : 0 };
+  auto block_type{ block_encoder_.get_smallest_block_type(bit_position) };
 
-    if (symbol.get_type() == DISTANCE) {
-      input_distance_codes.push_back(symbol.get_code());
-    } else {
-      input_ll_codes.push_back(symbol.get_code());
+  // Consecutive stored blocks are merged, and written out only once they are full, which saves their headers.
+  if (block_type == BlockEncoder::BlockType::STORED) {
+    stored_input_.append(block_input_);
+    if (stored_input_.length() > BlockEncoder::MAX_STORED_BLOCK_LENGTH) {
+      BlockEncoder::write_stored_block(
+        bit_writer_, std::string_view{ stored_input_ }.substr(0, BlockEncoder::MAX_STORED_BLOCK_LENGTH), false);
+      stored_input_.erase(0, BlockEncoder::MAX_STORED_BLOCK_LENGTH);
     }
-  }
-
-  // Compute the frequency of each symbol in the input.
-
-  std::unordered_map<unsigned int, unsigned int> input_ll_freqs{};
-  for (auto code : input_ll_codes) {
-    if (!input_ll_freqs.contains(code)) {
-      input_ll_freqs.insert({ code, 0 });
+  } else {
+    if (!stored_input_.empty()) {
+      BlockEncoder::write_stored_block(bit_writer_, stored_input_, false);
+      stored_input_.clear();
     }
-    input_ll_freqs.at(code)++;
+    block_encoder_.write_block(bit_writer_, block_type, is_last_block);
   }
 
-  std::unordered_map<unsigned int, unsigned int> input_distance_freqs{};
-  for (auto code : input_distance_codes) {
-    if (!input_distance_freqs.contains(code)) {
-      input_distance_freqs.insert({ code, 0 });
-    }
-    input_distance_freqs.at(code)++;
+  if (is_last_block && block_type == BlockEncoder::BlockType::STORED) {
+    BlockEncoder::write_stored_block(bit_writer_, stored_input_, true);
   }
 
-  // Compute separate prefix codes for length/literal symbols and distance symbols.
-
-  const unsigned int MAX_LL_DISTANCE_CODE_LENGTH{ 15 };
-  prefix_codes::PrefixCodeEncoder ll_encoder{ MAX_LL_DISTANCE_CODE_LENGTH };
-  ll_encoder.encode(input_ll_freqs);
-  prefix_codes::PrefixCodeEncoder distance_encoder{ MAX_LL_DISTANCE_CODE_LENGTH };
-  distance_encoder.encode(input_distance_freqs);
-
-  // Put all the length/literal and distance code lengths into a contiguous buffer.
-
-  auto ll_code_lengths{ ll_encoder.get_code_length_table() };
-  auto distance_code_lengths{ distance_encoder.get_code_length_table() };
-
-  std::vector<unsigned int> ll_distance_code_length_buffer{};
+  block_input_.clear();
+  is_block_storable_ = true;
+}
 
-  const unsigned int MAX_LL_CODE{ 285 };
-  unsigned int num_ll_codes{ 0 };
+void GzipWriter::write_footer()
+{
+  bit_writer_.pad_to_byte();
 
-  for (int code{ MAX_LL_CODE }; code >= 0; code--) {
-    if (ll_code_lengths.contains(code)) {
-      num_ll_codes = code + 1;
+  switch (format_) {
+    case StreamFormat::GZIP:
+      bit_writer_.put_bits(0, 32);  // XXX: Write CRC32.
+      bit_writer_.put_bits(input_size_, 32);
       break;
-    }
-  }
-
-  for (unsigned int code{ 0 }; code < num_ll_codes; code++) {
-    if (ll_code_lengths.contains(code)) {
-      ll_distance_code_length_buffer.push_back(ll_code_lengths.at(code));
-    } else {
-      ll_distance_code_length_buffer.push_back(0);
-    }
-  }
-
-  const unsigned int MAX_DISTANCE_CODE{ 29 };
-  unsigned int num_distance_codes{ 0 };
-
-  for (int code{ MAX_DISTANCE_CODE }; code >= 0; code--) {
-    if (distance_code_lengths.contains(code)) {
-      num_distance_codes = code + 1;
+    case StreamFormat::ZLIB:
+      put_big_endian(input_adler32_);
+      break;
+    case StreamFormat::RAW:
       break;
-    }
-  }
-
-  for (unsigned int code{ 0 }; code < num_distance_codes; code++) {
-    if (distance_code_lengths.contains(code)) {
-      ll_distance_code_length_buffer.push_back(distance_code_lengths.at(code));
-    } else {
-      ll_distance_code_length_buffer.push_back(0);
-    }
-  }
-
-  // Run-length encode the length/literal and distance length buffer.
-
-  struct ClSymbol
-  {
-    unsigned int code;
-    unsigned int repeat_count{ 0 };
-  };
-
-  std::vector<ClSymbol> rle_output{};
-
-  unsigned int repeat_count{ 0 };
-  unsigned int i;
-
-  for (i = 0; i < ll_distance_code_length_buffer.size(); i++) {
-    if (i == 0) {
-      rle_output.push_back({ ll_distance_code_length_buffer[i] });
-      continue;
-    }
-
-    if (ll_distance_code_length_buffer[i - 1] == ll_distance_code_length_buffer[i]) {
-      repeat_count++;
-      if (ll_distance_code_length_buffer[i] == 0) {
-        if (repeat_count == 138) {
-          rle_output.push_back({ 18, repeat_count });
-          repeat_count = 0;
-        }
-      } else {
-        if (repeat_count == 6) {
-          rle_output.push_back({ 16, repeat_count });
-          repeat_count = 0;
-        }
-      }
-      continue;
-    }
-
-    if (repeat_count >= 3) {
-      if (ll_distance_code_length_buffer[i - 1] == 0) {
-        if (repeat_count <= 10) {
-          rle_output.push_back({ 17, repeat_count });
-        } else {
-          rle_output.push_back({ 18, repeat_count });
-        }
-      } else {
-        rle_output.push_back({ 16, repeat_count });
-      }
-    } else if (repeat_count > 0) {
-      for (unsigned int j{ 0 }; j < repeat_count; j++) {
-        rle_output.push_back({ ll_distance_code_length_buffer[i - 1] });
-      }
-    }
-
-    rle_output.push_back({ ll_distance_code_length_buffer[i] });
-    repeat_count = 0;
-  }
-
-  // XXX: Can we avoid this repetition?
-  if (repeat_count >= 3) {
-    if (ll_distance_code_length_buffer[i - 1] == 0) {
-      if (repeat_count <= 10) {
-        rle_output.push_back({ 17, repeat_count });
-      } else {
-        rle_output.push_back({ 18, repeat_count });
-      }
-    } else {
-      rle_output.push_back({ 16, repeat_count });
-    }
-  } else if (repeat_count > 0) {
-    for (unsigned int j{ 0 }; j < repeat_count; j++) {
-      rle_output.push_back({ ll_distance_code_length_buffer[i - 1] });
-    }
   }
 
-  // Compute the frequency of each code length that occurs in the length/literal and distance code length buffer.
+  bit_writer_.finish();
+}
 
-  std::unordered_map<unsigned int, unsigned int> ll_distance_code_length_freqs{};
-  for (const auto &symbol : rle_output) {
-    if (!ll_distance_code_length_freqs.contains(symbol.code)) {
-      ll_distance_code_length_freqs.insert({ symbol.code, 0 });
-    }
-    ll_distance_code_length_freqs.at(symbol.code)++;
+void GzipWriter::put_big_endian(uint32_t value)
+{
+  // zlib numbers are the other way around to gzip ones.
+  for (int shift{ 24 }; shift >= 0; shift -= 8) {
+    bit_writer_.put_bits((value >> shift) & 0xff, 8);
   }
+}
 
-  // Compute the CL codes.
-
-  const unsigned int MAX_CL_CODE_LENGTH{ 7 };
-  prefix_codes::PrefixCodeEncoder cl_encoder{ MAX_CL_CODE_LENGTH };
-  cl_encoder.encode(ll_distance_code_length_freqs);
-
-  // Put the CL code lengths into a contiguous buffer. The codes go into the buffer in a weird order.
-
-  const std::array<unsigned int, 19> CL_CODE_LENGTH_ORDER{
-    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
-  };
-  auto cl_code_lengths{ cl_encoder.get_code_length_table() };
-
-  std::vector<unsigned int> cl_code_length_buffer{};
-  unsigned int num_cl_codes{ 0 };
-
-  for (unsigned int i{ 0 }; i < CL_CODE_LENGTH_ORDER.size(); i++) {
-    unsigned int code{ CL_CODE_LENGTH_ORDER[i] };
-
-    if (cl_code_lengths.contains(code)) {
-      cl_code_length_buffer.push_back(cl_code_lengths.at(code));
-      num_cl_codes = i + 1;
-    } else {
-      cl_code_length_buffer.push_back(0);
-    }
+std::string_view GzipWriter::read_input_chunk()
+{
+  if (input_block_.empty()) {
+    input_block_ = input_.read_block();
   }
 
-  // Write the number of codes of each type.
-
-  bit_writer_.put_bits(num_ll_codes - 257, 5);
-  bit_writer_.put_bits(num_distance_codes - 1, 5);
-  bit_writer_.put_bits(num_cl_codes - 4, 4);
-
-  // Write the CL code length table.
-
-  for (unsigned int i{ 0 }; i < num_cl_codes; i++) {
-    bit_writer_.put_bits(cl_code_length_buffer[i], 3);
+  // The block must not run out here, since `at_end_of_input()` would then read the next block over the top of it.
+  if (input_block_.size() > INPUT_CHUNK_SIZE) {
+    auto chunk{ input_block_.first(INPUT_CHUNK_SIZE) };
+    input_block_ = input_block_.subspan(INPUT_CHUNK_SIZE);
+    return { reinterpret_cast<const char *>(chunk.data()), chunk.size() };
   }
 
-  // Write the length/literal and distance code length tables.
+  input_chunk_.clear();
 
-  auto cl_codes{ cl_encoder.get_code_table() };
+  while (!input_block_.empty() && input_chunk_.length() < INPUT_CHUNK_SIZE) {
+    auto num_bytes{ std::min(input_block_.size(), INPUT_CHUNK_SIZE - input_chunk_.length()) };
+    input_chunk_.append(reinterpret_cast<const char *>(input_block_.data()), num_bytes);
 
-  for (const auto &symbol : rle_output) {
-    auto code{ cl_codes.at(symbol.code) };
-    auto length{ cl_code_lengths.at(symbol.code) };
-    bit_writer_.put_bits(code, length, false);
-
-    if (symbol.code == 16) {
-      bit_writer_.put_bits(symbol.repeat_count - 3, 2);
-    } else if (symbol.code == 17) {
-      bit_writer_.put_bits(symbol.repeat_count - 3, 3);
-    } else if (symbol.code == 18) {
-      bit_writer_.put_bits(symbol.repeat_count - 11, 7);
+    input_block_ = input_block_.subspan(num_bytes);
+    if (input_block_.empty()) {
+      input_block_ = input_.read_block();
     }
   }
 
-  // Write the compressed data.
-
-  auto ll_codes{ ll_encoder.get_code_table() };
-  auto distance_codes{ distance_encoder.get_code_table() };
-
-  for (const auto &symbol : symbol_list) {
-    using enum lzss::LzssSymbolType;
-
-    switch (symbol.get_type()) {
-      case LITERAL:
-      case LENGTH: {
-        auto code{ ll_codes.at(symbol.get_code()) };
-        auto length{ ll_code_lengths.at(symbol.get_code()) };
-        bit_writer_.put_bits(code, length, false);
-        break;
-      }
-      case DISTANCE: {
-        auto code{ distance_codes.at(symbol.get_code()) };
-        auto length{ distance_code_lengths.at(symbol.get_code()) };
-        bit_writer_.put_bits(code, length, false);
-        break;
-      }
-    }
-
-    if (symbol.get_type() == LITERAL) {
-      continue;
-    }
+  return input_chunk_;
+}
 
-    auto extra_bits{ symbol.get_extra_bits() };
-    if (extra_bits > 0) {
-      auto offset{ symbol.get_offset() };
-      bit_writer_.put_bits(offset, extra_bits);
-    }
+bool GzipWriter::at_end_of_input()
+{
+  if (input_block_.empty()) {
+    input_block_ = input_.read_block();
   }
+  return input_block_.empty();
 }
 
 }  // namespace gzip
\ No newline at end of file
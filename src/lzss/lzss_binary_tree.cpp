@@ -0,0 +1,152 @@
+#include "lzss/lzss_binary_tree.hpp"
+#include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_match_length.hpp"
+#include "lzss/lzss_window.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lzss {
+
+LzssBinaryTree::LzssBinaryTree(const LzssEncoderConfig &config)
+  : head_(HASH_SIZE, NO_POSITION), children_(2 * HALF_WINDOW_SIZE, NO_POSITION), max_depth_{ config.max_chain_length },
+    nice_length_{ config.nice_length }, good_length_{ config.good_length }
+{}
+
+void LzssBinaryTree::insert_up_to(uint64_t position)
+{
+  auto end_position{ window_.get_end_position() };
+  auto insert_end_position{ std::min(position, end_position - std::min<uint64_t>(end_position, 2)) };
+
+  for (; next_insert_position_ < insert_end_position; next_insert_position_++) {
+    auto max_length{ static_cast<unsigned int>(std::min<uint64_t>(
+      std::min(nice_length_, constants::MAX_BACKREF_LENGTH), end_position - next_insert_position_)) };
+    insert(next_insert_position_, max_length, constants::MIN_BACKREF_LENGTH - 1, max_depth_, [](const BackReference &) {});
+  }
+}
+
+void LzssBinaryTree::skip_to(uint64_t position)
+{
+  next_insert_position_ = std::max(next_insert_position_, position);
+}
+
+std::optional<BackReference> LzssBinaryTree::get_back_reference(uint64_t position,
+  unsigned int max_length,
+  unsigned int min_length)
+{
+  std::optional<BackReference> best_back_ref{};
+
+  if (max_length < constants::MIN_BACKREF_LENGTH || max_length <= min_length) {
+    return best_back_ref;
+  }
+
+  insert_up_to(position);
+  assert(next_insert_position_ == position && "searching at a position that is already inserted");
+
+  // A good match is already in hand, so a longer one is less likely to be worth the search.
+  auto max_depth{ min_length >= good_length_ ? std::max(max_depth_ / 4, 1U) : max_depth_ };
+
+  insert(position, std::min(nice_length_, max_length), min_length, max_depth, [&](const BackReference &back_ref) {
+    best_back_ref = back_ref;
+  });
+  next_insert_position_++;
+
+  return best_back_ref;
+}
+
+void LzssBinaryTree::find_back_references(uint64_t position,
+  unsigned int max_length,
+  std::vector<BackReference> &back_refs)
+{
+  if (max_length < constants::MIN_BACKREF_LENGTH) {
+    return;
+  }
+
+  insert_up_to(position);
+  assert(next_insert_position_ == position && "searching at a position that is already inserted");
+
+  insert(position, std::min(nice_length_, max_length), constants::MIN_BACKREF_LENGTH - 1, max_depth_,
+    [&](const BackReference &back_ref) { back_refs.push_back(back_ref); });
+  next_insert_position_++;
+}
+
+unsigned int LzssBinaryTree::hash_at(uint64_t position) const
+{
+  const auto *bytes{ window_.get_bytes(position) };
+  return ((((bytes[0] << HASH_SHIFT) ^ bytes[1]) << HASH_SHIFT) ^ bytes[2]) & (HASH_SIZE - 1);
+}
+
+template<typename MatchHandler>
+void LzssBinaryTree::insert(uint64_t position,
+  unsigned int max_length,
+  unsigned int min_length,
+  unsigned int max_depth,
+  MatchHandler handle_match)
+{
+  const auto *string{ window_.get_bytes(position) };
+
+  auto &root{ head_[hash_at(position)] };
+  auto candidate{ root };
+  root = position;
+
+  // The new position becomes the root. Nodes on the path that are smaller than its string go down its smaller side,
+  // each one in the larger child slot of the last, and the same the other way around for larger ones.
+  auto *smaller_slot{ &children_[2 * (position % HALF_WINDOW_SIZE)] };
+  auto *larger_slot{ smaller_slot + 1 };
+
+  // Every node below the last smaller node on the path shares at least `smaller_length` bytes with the string, and
+  // likewise for larger nodes, so comparisons can skip the shorter of the two.
+  unsigned int smaller_length{ 0 };
+  unsigned int larger_length{ 0 };
+
+  unsigned int best_length{ std::max(min_length, constants::MIN_BACKREF_LENGTH - 1) };
+
+  for (unsigned int depth{ 0 };; depth++) {
+    // Positions further down are always older, so once one is out of reach, the rest of the subtree is too. That also
+    // covers stale links to positions that have since been overwritten.
+    if (candidate == NO_POSITION || position - candidate > LzssWindow::MAX_DISTANCE
+        || candidate < window_.get_start_position() || depth == max_depth) {
+      *smaller_slot = NO_POSITION;
+      *larger_slot = NO_POSITION;
+      return;
+    }
+
+    const auto *search{ window_.get_bytes(candidate) };
+    auto *candidate_children{ &children_[2 * (candidate % HALF_WINDOW_SIZE)] };
+
+    auto length{ std::min(smaller_length, larger_length) };
+    length += get_match_length(string + length, search + length, max_length - length);
+
+    if (length > best_length) {
+      handle_match(BackReference{ candidate, length });
+      best_length = length;
+    }
+
+    // The strings can't be told apart within `max_length`. If that is the usual limit, the new position simply takes
+    // the candidate's place. A shorter limit means the string runs into the end of the window, and the candidate's
+    // subtree may have been sorted on bytes past it, so it is dropped rather than risk putting it on the wrong side.
+    if (length == max_length) {
+      auto is_full_length{ max_length == std::min(nice_length_, constants::MAX_BACKREF_LENGTH) };
+      *smaller_slot = is_full_length ? candidate_children[0] : NO_POSITION;
+      *larger_slot = is_full_length ? candidate_children[1] : NO_POSITION;
+      return;
+    }
+
+    if (search[length] < string[length]) {
+      *smaller_slot = candidate;
+      smaller_slot = &candidate_children[1];
+      smaller_length = length;
+      candidate = *smaller_slot;
+    } else {
+      *larger_slot = candidate;
+      larger_slot = &candidate_children[0];
+      larger_length = length;
+      candidate = *larger_slot;
+    }
+  }
+}
+
+}  // namespace lzss
@@ -0,0 +1,117 @@
+#include "lzss/lzss_dictionary_builder.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lzss {
+
+namespace {
+
+  // Strings are scored by how many samples share the `KEY_LENGTH`-byte substrings in them, and the dictionary is made
+  // of `SEGMENT_LENGTH`-byte pieces of the samples with the best scores.
+  const std::size_t KEY_LENGTH{ 8 };
+  const std::size_t SEGMENT_LENGTH{ 64 };
+
+  struct KeyCount
+  {
+    unsigned int num_samples{ 0 };
+    std::size_t last_sample{ SIZE_MAX };
+  };
+
+  struct Segment
+  {
+    std::size_t start;
+    unsigned int score;
+  };
+
+}  // namespace
+
+std::string build_dictionary(std::span<const std::string> samples, std::size_t max_size)
+{
+  std::string text{};
+  for (const auto &sample : samples) {
+    text += sample;
+  }
+
+  // Count the samples each key appears in. Counting every appearance instead would favour strings repeated within one
+  // sample, which the encoder finds without any help. `counts` points each position at the count for the key starting
+  // there, if a whole key fits in its sample.
+  std::unordered_map<std::string_view, KeyCount> key_counts{};
+  std::vector<unsigned int *> counts(text.length(), nullptr);
+
+  std::size_t sample_start{ 0 };
+  for (std::size_t sample_index{ 0 }; sample_index < samples.size(); sample_index++) {
+    auto sample_end{ sample_start + samples[sample_index].length() };
+
+    for (auto i{ sample_start }; i + KEY_LENGTH <= sample_end; i++) {
+      auto &count{ key_counts[std::string_view{ text }.substr(i, KEY_LENGTH)] };
+      if (count.last_sample != sample_index) {
+        count.last_sample = sample_index;
+        count.num_samples++;
+      }
+      counts[i] = &count.num_samples;
+    }
+
+    sample_start = sample_end;
+  }
+
+  // A key that appears in only one sample is no help at all.
+  auto get_score = [&](std::size_t i) { return counts[i] != nullptr && *counts[i] > 1 ? *counts[i] : 0; };
+
+  // The text is split into one epoch per segment that fits in the dictionary, and the best segment of each epoch is
+  // taken, as in zstd's cover algorithm. Keys in a segment that is taken stop counting towards later ones, so the same
+  // strings don't go in twice.
+  std::vector<Segment> segments{};
+  auto num_epochs{ std::max<std::size_t>(max_size / SEGMENT_LENGTH, 1) };
+  auto epoch_size{ std::max(text.length() / num_epochs, SEGMENT_LENGTH) };
+  const auto NUM_KEYS_PER_SEGMENT{ SEGMENT_LENGTH - KEY_LENGTH + 1 };
+
+  for (std::size_t epoch_start{ 0 }; epoch_start + SEGMENT_LENGTH <= text.length(); epoch_start += epoch_size) {
+    auto epoch_end{ std::min(epoch_start + epoch_size, text.length()) };
+
+    // The score of each segment is the sum over the keys in it, kept up to date as the segment slides along.
+    unsigned int score{ 0 };
+    for (auto i{ epoch_start }; i < epoch_start + NUM_KEYS_PER_SEGMENT; i++) {
+      score += get_score(i);
+    }
+
+    Segment best_segment{ epoch_start, score };
+    for (auto start{ epoch_start + 1 }; start + SEGMENT_LENGTH <= epoch_end; start++) {
+      score += get_score(start + NUM_KEYS_PER_SEGMENT - 1);
+      score -= get_score(start - 1);
+      if (score > best_segment.score) {
+        best_segment = { start, score };
+      }
+    }
+
+    if (best_segment.score == 0) {
+      continue;
+    }
+
+    segments.push_back(best_segment);
+    for (auto i{ best_segment.start }; i < best_segment.start + NUM_KEYS_PER_SEGMENT; i++) {
+      if (counts[i] != nullptr) {
+        *counts[i] = 0;
+      }
+    }
+  }
+
+  // Keep the best segments that fit, with the best last.
+  std::stable_sort(segments.begin(), segments.end(), [](const auto &a, const auto &b) { return a.score > b.score; });
+  segments.resize(std::min(segments.size(), max_size / SEGMENT_LENGTH));
+  std::reverse(segments.begin(), segments.end());
+
+  std::string dictionary{};
+  for (const auto &segment : segments) {
+    dictionary += std::string_view{ text }.substr(segment.start, SEGMENT_LENGTH);
+  }
+  return dictionary;
+}
+
+}  // namespace lzss
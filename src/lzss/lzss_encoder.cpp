@@ -1,55 +1,312 @@
 #include "lzss/lzss_encoder.hpp"
+#include "lzss/lzss_binary_tree.hpp"
 #include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+#include "lzss/lzss_hash_table.hpp"
 #include "lzss/lzss_string_table.hpp"
 #include "lzss/lzss_symbol.hpp"
+#include "lzss/lzss_window.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
 namespace lzss {
 
-void LzssEncoder::encode(std::string_view input_buffer)
+LzssEncoder::LzssEncoder(const LzssEncoderConfig &config)
+  : match_finder_{ make_match_finder(config) }, strategy_{ config.strategy }, max_lazy_length_{ config.max_lazy_length },
+    max_insert_length_{ config.max_insert_length },
+    optimal_parse_{ config.optimal_parse_iterations > 0 }, optimal_parser_{ config.optimal_parse_iterations }
+{}
+
+LzssEncoder::MatchFinder LzssEncoder::make_match_finder(const LzssEncoderConfig &config)
+{
+  if (config.strategy == Strategy::RLE || config.strategy == Strategy::HUFFMAN_ONLY) {
+    return MatchFinder{};
+  }
+
+  switch (config.match_finder_type) {
+    using enum MatchFinderType;
+
+    case HASH_TABLE:
+      return MatchFinder{ std::in_place_type<LzssHashTable>, config };
+    case BINARY_TREE:
+      return MatchFinder{ std::in_place_type<LzssBinaryTree>, config };
+    default:
+      return MatchFinder{ std::in_place_type<LzssStringTable>, config };
+  }
+}
+
+void LzssEncoder::set_dictionary(std::string_view dictionary)
+{
+  assert(current_position_ == 0 && "setting a dictionary after encoding");
+
+  if (dictionary.length() > LzssWindow::MAX_DISTANCE) {
+    dictionary.remove_prefix(dictionary.length() - LzssWindow::MAX_DISTANCE);
+  }
+
+  if (!dictionary.empty()) {
+    previous_byte_ = static_cast<unsigned char>(dictionary.back());
+  }
+
+  std::visit(
+    [&]<typename Finder>(Finder &match_finder) {
+      if constexpr (std::is_same_v<Finder, std::monostate>) {
+        current_position_ = dictionary.length();
+      } else {
+        while (!dictionary.empty()) {
+          dictionary.remove_prefix(match_finder.append(dictionary, current_position_));
+        }
+
+        current_position_ = match_finder.get_end_position();
+        match_finder.insert_up_to(current_position_);
+      }
+    },
+    match_finder_);
+}
+
+std::size_t LzssEncoder::encode(std::string_view input_buffer, bool start_new_block)
+{
+  assert((start_new_block || !symbol_buffer_.should_end_block()) && "continuing a block that has ended");
+  if (start_new_block) {
+    symbol_buffer_.clear();
+  }
+  auto start_position{ current_position_ };
+
+  switch (strategy_) {
+    using enum Strategy;
+
+    case RLE:
+      encode_runs(input_buffer);
+      return current_position_ - start_position;
+    case HUFFMAN_ONLY:
+      encode_literals(input_buffer);
+      return current_position_ - start_position;
+    default:
+      break;
+  }
+
+  std::visit(
+    [&]<typename Finder>(Finder &match_finder) {
+      if constexpr (std::is_same_v<Finder, std::monostate>) {
+        assert(false && "no match finder for the strategy");
+      } else if constexpr (std::is_same_v<Finder, LzssHashTable>) {
+        encode_fastest(match_finder, input_buffer);
+      } else if (optimal_parse_) {
+        encode_optimal(match_finder, input_buffer);
+      } else {
+        encode_lazy(match_finder, input_buffer);
+      }
+    },
+    match_finder_);
+
+  return current_position_ - start_position;
+}
+
+void LzssEncoder::encode_fastest(LzssHashTable &hash_table, std::string_view input_buffer)
 {
-  symbol_list_.clear();
+  auto end_position{ current_position_ + input_buffer.length() };
+  skip_buffered_input(hash_table, input_buffer);
 
-  unsigned int input_pos{ 0 };
+  // Every `SKIP_STEP` positions in a row without a match, the search moves ahead one byte further each time, up to
+  // `MAX_SKIP_LENGTH` bytes. Input that doesn't compress gets through quickly, and any match resets the pace.
+  const unsigned int SKIP_STEP{ 32 };
+  const unsigned int MAX_SKIP_LENGTH{ 64 };
+  unsigned int num_misses{ 0 };
 
-  while (input_pos < input_buffer.length()) {
-    std::string string{ input_buffer.substr(input_pos, constants::MAX_BACKREF_LENGTH) };
-    auto back_ref{ string_table_.get_back_reference(string) };
+  while (current_position_ < end_position && !symbol_buffer_.should_end_block()) {
+    fill_window(hash_table, input_buffer);
 
-    string_table_.insert(string, current_position_);
+    auto back_ref{ hash_table.get_back_reference(current_position_, get_max_length(current_position_, end_position)) };
 
     if (!back_ref.has_value()) {
-      output_literal(input_buffer[input_pos]);
-      input_pos++;
+      auto skip_length{ std::min<uint64_t>({ 1 + num_misses / SKIP_STEP,
+        MAX_SKIP_LENGTH,
+        end_position - current_position_,
+        symbol_buffer_.get_free_space() }) };
+      num_misses++;
+
+      for (uint64_t i{ 0 }; i < skip_length; i++) {
+        output_literal(hash_table.get_byte(current_position_));
+      }
+      hash_table.skip_to(current_position_);
       continue;
     }
 
+    num_misses = 0;
+
     auto [position, length]{ back_ref.value() };
-    auto distance{ current_position_ - position };
+    output_back_reference(length, current_position_ - position);
+    insert_back_reference(hash_table, length);
+  }
+}
+
+void LzssEncoder::encode_runs(std::string_view input_buffer)
+{
+  // The only match ever looked for is a run of the previous byte, so there is no match finder. A run still going at the
+  // end of the input is written then, since the block may end there, but it carries on in the next call.
+  std::size_t i{ 0 };
+
+  while (i < input_buffer.length() && !symbol_buffer_.should_end_block()) {
+    std::size_t length{ 0 };
+    if (previous_byte_.has_value()) {
+      auto max_length{ std::min<std::size_t>(constants::MAX_BACKREF_LENGTH, input_buffer.length() - i) };
+      while (length < max_length && static_cast<unsigned char>(input_buffer[i + length]) == previous_byte_) {
+        length++;
+      }
+    }
+
+    if (length >= constants::MIN_BACKREF_LENGTH) {
+      output_back_reference(static_cast<unsigned int>(length), 1);
+      i += length;
+    } else {
+      previous_byte_ = static_cast<unsigned char>(input_buffer[i]);
+      output_literal(previous_byte_.value());
+      i++;
+    }
+  }
+}
+
+void LzssEncoder::encode_literals(std::string_view input_buffer)
+{
+  for (std::size_t i{ 0 }; i < input_buffer.length() && !symbol_buffer_.should_end_block(); i++) {
+    output_literal(static_cast<unsigned char>(input_buffer[i]));
+  }
+}
+
+template<typename Finder>
+void LzssEncoder::encode_lazy(Finder &match_finder, std::string_view input_buffer)
+{
+  auto end_position{ current_position_ + input_buffer.length() };
+  skip_buffered_input(match_finder, input_buffer);
+
+  while (current_position_ < end_position && !symbol_buffer_.should_end_block()) {
+    fill_window(match_finder, input_buffer);
 
-    if (distance > constants::MAX_BACKREF_DISTANCE) {
-      output_literal(input_buffer[input_pos]);
-      input_pos++;
+    auto back_ref{ next_back_ref_ };
+    next_back_ref_.reset();
+    if (!back_ref.has_value()) {
+      back_ref = match_finder.get_back_reference(current_position_, get_max_length(current_position_, end_position));
+    }
+
+    if (!back_ref.has_value()) {
+      output_literal(match_finder.get_byte(current_position_));
+      match_finder.insert_up_to(current_position_);
       continue;
     }
 
-    output_back_reference(length, distance);
-    input_pos += length;
+    // Lazy evaluation: if the next position starts a longer match, a literal here followed by that match beats taking
+    // this one.
+    if (back_ref->length < max_lazy_length_) {
+      auto next_position{ current_position_ + 1 };
+      match_finder.insert_up_to(next_position);
+      next_back_ref_ = match_finder.get_back_reference(
+        next_position, get_max_length(next_position, end_position), back_ref->length);
+
+      if (next_back_ref_.has_value()) {
+        output_literal(match_finder.get_byte(current_position_));
+        continue;
+      }
+    }
+
+    auto [position, length]{ back_ref.value() };
+    output_back_reference(length, current_position_ - position);
+    insert_back_reference(match_finder, length);
+  }
+}
+
+template<typename Finder>
+void LzssEncoder::insert_back_reference(Finder &match_finder, unsigned int length)
+{
+  // Inserting every position inside a long match costs time for little gain, so only its first position goes in.
+  if (length > max_insert_length_) {
+    match_finder.insert_up_to(current_position_ - length + 1);
+    match_finder.skip_to(current_position_);
+    return;
+  }
+  match_finder.insert_up_to(current_position_);
+}
+
+template<typename Finder>
+void LzssEncoder::encode_optimal(Finder &match_finder, std::string_view input_buffer)
+{
+  auto input{ input_buffer };
+  auto start_position{ current_position_ };
+
+  // All of the input is parsed at once, but only as much of the parse as fits in the symbol buffer is output. The
+  // calls after are given the rest of the input, and output the rest of the parse.
+  if (remaining_steps_.empty()) {
+    auto end_position{ current_position_ + input_buffer.length() };
+    skip_buffered_input(match_finder, input_buffer);
+
+    // Collect the back-references at every position first, since the parse can use any of them.
+    back_refs_.clear();
+    back_ref_offsets_.clear();
+
+    for (; current_position_ < end_position; current_position_++) {
+      fill_window(match_finder, input_buffer);
+      match_finder.insert_up_to(current_position_);
+
+      back_ref_offsets_.push_back(back_refs_.size());
+      match_finder.find_back_references(
+        current_position_, get_max_length(current_position_, end_position), back_refs_);
+    }
+    back_ref_offsets_.push_back(back_refs_.size());
+
+    current_position_ = start_position;
+    remaining_steps_ = optimal_parser_.parse(input, start_position, back_refs_, back_ref_offsets_);
+  }
+
+  for (; !remaining_steps_.empty() && !symbol_buffer_.should_end_block(); remaining_steps_ = remaining_steps_.subspan(1)) {
+    const auto &step{ remaining_steps_.front() };
+    if (step.distance == 0) {
+      output_literal(static_cast<unsigned char>(input[current_position_ - start_position]));
+    } else {
+      output_back_reference(step.length, step.distance);
+    }
+  }
+}
+
+template<typename Finder>
+void LzssEncoder::skip_buffered_input(const Finder &match_finder, std::string_view &input_buffer) const
+{
+  // If the last call stopped early, the start of its input was already added to the window.
+  input_buffer.remove_prefix(match_finder.get_end_position() - current_position_);
+}
+
+template<typename Finder>
+void LzssEncoder::fill_window(Finder &match_finder, std::string_view &input_buffer)
+{
+  // Keep enough input in the window to find the longest possible match one position ahead, as long as there is more
+  // input to add.
+  while (match_finder.get_end_position() - current_position_ < LzssWindow::MIN_LOOKAHEAD
+         && !input_buffer.empty()) {
+    input_buffer.remove_prefix(match_finder.append(input_buffer, current_position_));
   }
 }
 
+unsigned int LzssEncoder::get_max_length(uint64_t position, uint64_t end_position) const
+{
+  // Matches stop at the end of the input buffer, so that each call encodes exactly the input it was given.
+  return static_cast<unsigned int>(std::min<uint64_t>(constants::MAX_BACKREF_LENGTH, end_position - position));
+}
+
 void LzssEncoder::output_back_reference(unsigned int length, unsigned int distance)
 {
-  symbol_list_.add({ LzssSymbolType::LENGTH, length });
-  symbol_list_.add({ LzssSymbolType::DISTANCE, distance });
+  symbol_buffer_.add({ length, distance });
   current_position_ += length;
 }
 
 void LzssEncoder::output_literal(unsigned int value)
 {
-  // XXX: Nasty static cast...
-  symbol_list_.add({ LzssSymbolType::LITERAL, static_cast<unsigned char>(value) });
+  symbol_buffer_.add(static_cast<unsigned char>(value));
   current_position_++;
 }
 
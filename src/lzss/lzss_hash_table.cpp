@@ -0,0 +1,79 @@
+#include "lzss/lzss_hash_table.hpp"
+#include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_match_length.hpp"
+#include "lzss/lzss_window.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace lzss {
+
+LzssHashTable::LzssHashTable(const LzssEncoderConfig &) : head_(HASH_SIZE, NO_POSITION) {}
+
+void LzssHashTable::insert_up_to(uint64_t position)
+{
+  auto end_position{ window_.get_end_position() };
+  auto insert_end_position{ std::min(position, end_position - std::min<uint64_t>(end_position, HASH_LENGTH - 1)) };
+
+  for (; next_insert_position_ < insert_end_position; next_insert_position_++) {
+    head_[hash_at(next_insert_position_)] = next_insert_position_;
+  }
+}
+
+void LzssHashTable::skip_to(uint64_t position)
+{
+  next_insert_position_ = std::max(next_insert_position_, position);
+}
+
+std::optional<BackReference> LzssHashTable::get_back_reference(uint64_t position,
+  unsigned int max_length,
+  unsigned int min_length)
+{
+  // Matches too short to cover the hash could never have been found.
+  if (max_length < HASH_LENGTH || max_length <= min_length) {
+    return {};
+  }
+
+  insert_up_to(position);
+  assert(next_insert_position_ == position && "searching at a position that is already inserted");
+
+  auto &head{ head_[hash_at(position)] };
+  auto candidate{ head };
+  head = position;
+  next_insert_position_++;
+
+  if (candidate == NO_POSITION || position - candidate > LzssWindow::MAX_DISTANCE
+      || candidate < window_.get_start_position()) {
+    return {};
+  }
+
+  auto length{ get_match_length(window_.get_bytes(position), window_.get_bytes(candidate), max_length) };
+  if (length < constants::MIN_BACKREF_LENGTH || length <= min_length) {
+    return {};
+  }
+  return BackReference{ candidate, length };
+}
+
+void LzssHashTable::find_back_references(uint64_t position,
+  unsigned int max_length,
+  std::vector<BackReference> &back_refs)
+{
+  auto back_ref{ get_back_reference(position, max_length) };
+  if (back_ref.has_value()) {
+    back_refs.push_back(back_ref.value());
+  }
+}
+
+unsigned int LzssHashTable::hash_at(uint64_t position) const
+{
+  // Multiplicative hashing of the next four bytes, which leaves the best mixed bits at the top.
+  uint32_t bytes;
+  std::memcpy(&bytes, window_.get_bytes(position), sizeof(bytes));
+  return (bytes * 2654435761U) >> (32 - HASH_BITS);
+}
+
+}  // namespace lzss
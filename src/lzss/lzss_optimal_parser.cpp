@@ -0,0 +1,155 @@
+#include "lzss/lzss_optimal_parser.hpp"
+#include "lzss/lzss_code_tables.hpp"
+#include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_window.hpp"
+#include "lzss/lzss_symbol.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace lzss {
+
+LzssOptimalParser::LzssOptimalParser(unsigned int num_iterations) : num_iterations_{ num_iterations } {}
+
+const std::vector<LzssOptimalParser::Step> &LzssOptimalParser::parse(std::string_view input,
+  uint64_t start_position,
+  const std::vector<BackReference> &back_refs,
+  const std::vector<std::size_t> &offsets)
+{
+  set_initial_costs();
+
+  // Each parse is measured with the codes built for it, which is what it would actually cost, and the cheapest one
+  // is kept. Later iterations usually do better, but aren't guaranteed to.
+  uint64_t best_cost{ std::numeric_limits<uint64_t>::max() };
+
+  for (unsigned int i{ 0 }; i < std::max(num_iterations_, 1U); i++) {
+    find_cheapest_parse(input, start_position, back_refs, offsets);
+
+    auto cost{ update_costs(input) };
+    if (cost < best_cost) {
+      best_cost = cost;
+      std::swap(best_steps_, steps_);
+    }
+  }
+
+  return best_steps_;
+}
+
+void LzssOptimalParser::set_initial_costs()
+{
+  // Roughly the fixed prefix codes, before there is a parse to go by.
+  std::fill(literal_costs_.begin(), literal_costs_.end(), 8);
+  std::fill(distance_code_costs_.begin(), distance_code_costs_.end(), 5);
+
+  for (unsigned int length{ constants::MIN_BACKREF_LENGTH }; length <= constants::MAX_BACKREF_LENGTH; length++) {
+    length_costs_[length] = 7 + code_tables::get_length_entry_by_length(length).extra_bits;
+  }
+}
+
+void LzssOptimalParser::find_cheapest_parse(std::string_view input,
+  uint64_t start_position,
+  const std::vector<BackReference> &back_refs,
+  const std::vector<std::size_t> &offsets)
+{
+  auto size{ input.length() };
+
+  path_costs_.assign(size + 1, std::numeric_limits<uint64_t>::max());
+  path_steps_.resize(size + 1);
+  path_costs_[0] = 0;
+
+  for (std::size_t i{ 0 }; i < size; i++) {
+    auto cost{ path_costs_[i] };
+
+    auto literal_cost{ cost + literal_costs_[static_cast<unsigned char>(input[i])] };
+    if (literal_cost < path_costs_[i + 1]) {
+      path_costs_[i + 1] = literal_cost;
+      path_steps_[i + 1] = { 1, 0 };
+    }
+
+    // Back-references come in increasing length, and every length between the previous one and the next is made
+    // from the closer one.
+    unsigned int min_length{ constants::MIN_BACKREF_LENGTH };
+
+    for (auto j{ offsets[i] }; j < offsets[i + 1]; j++) {
+      auto distance{ static_cast<unsigned int>(start_position + i - back_refs[j].position) };
+      auto distance_entry{ code_tables::get_distance_entry_by_distance(distance) };
+      auto distance_cost{ cost + distance_code_costs_[distance_entry.code] + distance_entry.extra_bits };
+
+      for (auto length{ min_length }; length <= back_refs[j].length; length++) {
+        auto match_cost{ distance_cost + length_costs_[length] };
+        if (match_cost < path_costs_[i + length]) {
+          path_costs_[i + length] = match_cost;
+          path_steps_[i + length] = { static_cast<uint16_t>(length), static_cast<uint16_t>(distance) };
+        }
+      }
+      min_length = back_refs[j].length + 1;
+    }
+  }
+
+  // Follow the steps back from the end, then put them in order.
+  steps_.clear();
+  for (auto i{ size }; i > 0; i -= path_steps_[i].length) {
+    steps_.push_back(path_steps_[i]);
+  }
+  std::reverse(steps_.begin(), steps_.end());
+}
+
+uint64_t LzssOptimalParser::update_costs(std::string_view input)
+{
+  prefix_codes::FrequencyTable ll_frequencies{};
+  prefix_codes::FrequencyTable distance_frequencies{};
+
+  std::size_t position{ 0 };
+  for (const auto &step : steps_) {
+    if (step.distance == 0) {
+      ll_frequencies[static_cast<unsigned char>(input[position])]++;
+    } else {
+      ll_frequencies[code_tables::get_length_entry_by_length(step.length).code]++;
+      distance_frequencies[code_tables::get_distance_entry_by_distance(step.distance).code]++;
+    }
+    position += step.length;
+  }
+  ll_frequencies[END_OF_BLOCK_CODE]++;
+
+  ll_encoder_.encode(ll_frequencies);
+  distance_encoder_.encode(distance_frequencies);
+
+  const auto &ll_code_lengths{ ll_encoder_.get_code_length_table() };
+  const auto &distance_code_lengths{ distance_encoder_.get_code_length_table() };
+
+  // Symbols the parse didn't use have no code yet. Pricing them at the longest code length keeps them possible, but
+  // discourages them.
+  auto get_cost = [](unsigned int code_length) { return code_length == 0 ? MAX_CODE_LENGTH : code_length; };
+
+  uint64_t total_cost{ 0 };
+
+  for (unsigned int code{ 0 }; code < NUM_LL_CODES; code++) {
+    total_cost += static_cast<uint64_t>(ll_frequencies[code]) * ll_code_lengths[code];
+    literal_costs_[code] = get_cost(ll_code_lengths[code]);
+  }
+  for (unsigned int code{ 0 }; code < NUM_DISTANCE_CODES; code++) {
+    const auto &entry{ code_tables::get_distance_entry_by_code(code) };
+    total_cost += static_cast<uint64_t>(distance_frequencies[code]) * (distance_code_lengths[code] + entry.extra_bits);
+    distance_code_costs_[code] = get_cost(distance_code_lengths[code]);
+  }
+  for (unsigned int length{ constants::MIN_BACKREF_LENGTH }; length <= constants::MAX_BACKREF_LENGTH; length++) {
+    const auto &entry{ code_tables::get_length_entry_by_length(length) };
+    length_costs_[length] = get_cost(ll_code_lengths[entry.code]) + entry.extra_bits;
+  }
+
+  // Extra bits of lengths, which the frequencies don't capture.
+  for (const auto &step : steps_) {
+    if (step.distance != 0) {
+      total_cost += code_tables::get_length_entry_by_length(step.length).extra_bits;
+    }
+  }
+
+  return total_cost;
+}
+
+}  // namespace lzss
@@ -1,73 +1,118 @@
 #include "lzss/lzss_string_table.hpp"
 #include "lzss/lzss_constants.hpp"
+#include "lzss/lzss_match_length.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <optional>
-#include <string>
 #include <string_view>
 
 namespace lzss {
 
-LzssStringTable::LzssStringTable(unsigned int max_chain_length) : max_chain_length_{ max_chain_length } {}
+LzssStringTable::LzssStringTable(const LzssEncoderConfig &config)
+  : head_(HASH_SIZE, NO_POSITION), prev_(HALF_WINDOW_SIZE, NO_POSITION),
+    max_chain_length_{ config.max_chain_length }, nice_length_{ config.nice_length }, good_length_{ config.good_length }
+{}
 
-void LzssStringTable::insert(std::string_view string, unsigned int position)
+void LzssStringTable::insert_up_to(uint64_t position)
 {
-  auto index{ get_chain_index(string) };
-  auto &chain{ chains_[index] };
-  chain.push_front({ std::string{ string }, position });
-  if (chain.size() > max_chain_length_) {
-    chain.pop_back();
-  }
-}
-
-std::optional<BackReference> LzssStringTable::get_back_reference(std::string_view string) const
-{
-  auto index{ get_chain_index(string) };
-
-  for (const auto &[search, position] : chains_[index]) {
-    unsigned int length{ 0 };
+  auto end_position{ std::min(position, get_end_position() - std::min<uint64_t>(get_end_position(), 2)) };
 
-    for (unsigned int i{ 0 }; i < string.length(); i++) {
-      if (i == search.length() || string[i] != search[i]) {
-        break;
-      }
-      length++;
+  for (; next_insert_position_ < end_position; next_insert_position_++) {
+    // The hash of the previous position already covers the first two bytes, unless there is no previous one.
+    if (next_insert_position_ == hash_start_position_) {
+      const auto *bytes{ window_.get_bytes(next_insert_position_) };
+      insert_hash_ = update_hash(update_hash(0, bytes[0]), bytes[1]);
     }
+    insert_hash_ = update_hash(insert_hash_, window_.get_bytes(next_insert_position_)[2]);
 
-    if (length >= constants::MIN_BACKREF_LENGTH) {
-      return BackReference{ position, length };
-    }
+    prev_[next_insert_position_ % HALF_WINDOW_SIZE] = head_[insert_hash_];
+    head_[insert_hash_] = next_insert_position_;
   }
+}
 
-  return {};
+void LzssStringTable::skip_to(uint64_t position)
+{
+  if (position > next_insert_position_) {
+    next_insert_position_ = position;
+    hash_start_position_ = position;
+  }
 }
 
-std::size_t LzssStringTable::get_chain_index(std::string_view string) const
+std::optional<BackReference> LzssStringTable::get_back_reference(uint64_t position,
+  unsigned int max_length,
+  unsigned int min_length) const
 {
-  std::string key{ string.substr(0, 3) };
-  return hash_(key) % std::size(chains_);
+  std::optional<BackReference> best_back_ref{};
+  search(position, max_length, min_length, [&](const BackReference &back_ref) { best_back_ref = back_ref; });
+  return best_back_ref;
 }
 
-unsigned int LzssStringTable::get_average_chain_length() const
+void LzssStringTable::find_back_references(uint64_t position,
+  unsigned int max_length,
+  std::vector<BackReference> &back_refs) const
 {
-  unsigned int total{ 0 };
-  for (const auto &chain : chains_) {
-    total += chain.size();
-  }
-  return total / std::size(chains_);
+  search(position, max_length, constants::MIN_BACKREF_LENGTH - 1, [&](const BackReference &back_ref) {
+    back_refs.push_back(back_ref);
+  });
 }
 
-std::string LzssStringTable::to_string() const
+template<typename MatchHandler>
+void LzssStringTable::search(uint64_t position,
+  unsigned int max_length,
+  unsigned int min_length,
+  MatchHandler handle_match) const
 {
-  std::string result{};
+  if (max_length < constants::MIN_BACKREF_LENGTH || max_length <= min_length) {
+    return;
+  }
 
-  for (const auto &chain : chains_) {
-    for (const auto &[string, position] : chain) {
-      result += "(" + string + ", " + std::to_string(position) + ")\n";
+  const auto *string{ window_.get_bytes(position) };
+  auto candidate{ head_[hash_at(position)] };
+
+  unsigned int best_length{ std::max(min_length, constants::MIN_BACKREF_LENGTH - 1) };
+
+  // A good match is already in hand, so a longer one is less likely to be worth the search.
+  auto max_chain_length{ min_length >= good_length_ ? std::max(max_chain_length_ / 4, 1U) : max_chain_length_ };
+  auto nice_length{ std::min(nice_length_, max_length) };
+
+  for (unsigned int i{ 0 }; i < max_chain_length; i++) {
+    // Chains run from newer to older positions. Anything out of reach ends the search, including stale links left in
+    // `prev_` by positions that have since been overwritten.
+    if (candidate == NO_POSITION || position - candidate > LzssWindow::MAX_DISTANCE
+        || candidate < window_.get_start_position()) {
+      break;
+    }
+
+    const auto *search{ window_.get_bytes(candidate) };
+
+    // A candidate can only beat the best match so far if it matches one byte further, so check that byte first. Only
+    // strictly longer matches are taken, so ties go to the closest candidate.
+    if (search[best_length] == string[best_length]) {
+      auto length{ get_match_length(string, search, max_length) };
+      if (length > best_length) {
+        handle_match(BackReference{ candidate, length });
+        best_length = length;
+
+        if (length >= nice_length) {
+          break;
+        }
+      }
+    }
+
+    auto next_candidate{ prev_[candidate % HALF_WINDOW_SIZE] };
+    if (next_candidate >= candidate) {
+      break;
     }
+    candidate = next_candidate;
   }
+}
 
-  return result;
+unsigned int LzssStringTable::hash_at(uint64_t position) const
+{
+  const auto *bytes{ window_.get_bytes(position) };
+  return update_hash(update_hash(update_hash(0, bytes[0]), bytes[1]), bytes[2]);
 }
 
 }  // namespace lzss
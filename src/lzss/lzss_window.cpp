@@ -0,0 +1,34 @@
+#include "lzss/lzss_window.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace lzss {
+
+LzssWindow::LzssWindow() : bytes_(WINDOW_SIZE + PADDING_SIZE) {}
+
+std::size_t LzssWindow::append(std::string_view input, uint64_t position)
+{
+  if (end_ == WINDOW_SIZE && position - start_ >= HALF_WINDOW_SIZE + MAX_DISTANCE) {
+    slide();
+  }
+
+  auto num_bytes{ std::min(input.length(), WINDOW_SIZE - end_) };
+  std::copy_n(input.begin(), num_bytes, reinterpret_cast<char *>(bytes_.data()) + end_);
+  end_ += num_bytes;
+
+  return num_bytes;
+}
+
+void LzssWindow::slide()
+{
+  // Positions are absolute, so match finders are unaffected. Any of their links to the dropped half are out of reach,
+  // and are caught by the range checks when searching.
+  std::copy(bytes_.begin() + HALF_WINDOW_SIZE, bytes_.begin() + WINDOW_SIZE, bytes_.begin());
+  start_ += HALF_WINDOW_SIZE;
+  end_ -= HALF_WINDOW_SIZE;
+}
+
+}  // namespace lzss
@@ -1,83 +1,55 @@
 #include "prefix_codes/prefix_code_decoder.hpp"
 #include "bit_io/bit_reader.hpp"
-#include "prefix_codes/canonical_codes.hpp"
-
-#include <memory>
+#include "prefix_codes/decoding_table.hpp"
 
 namespace prefix_codes {
 
-PrefixCodeDecoder::PrefixCodeDecoder(bit_io::BitReader &bit_reader, const CodeLengthTable &code_length_table)
-  : code_length_table_{ code_length_table }, bit_reader_{ bit_reader }
+PrefixCodeDecoder::PrefixCodeDecoder(bit_io::BitReader &bit_reader, const DecodingTable &table)
+  : bit_reader_{ bit_reader }, table_{ table }
 {}
 
-void PrefixCodeDecoder::initialize()
-{
-  compute_code_table();
-  build_tree();
-}
+PrefixCodeDecoder::PrefixCodeDecoder(bit_io::BitReader &bit_reader,
+  const DecodingTable &table,
+  const MultiLiteralTable &multi_table)
+  : bit_reader_{ bit_reader }, table_{ table }, multi_table_{ &multi_table }
+{}
 
 unsigned int PrefixCodeDecoder::decode_symbol()
 {
-  NodePtr current{ tree_root_ };
-  while (true) {
-    if (current == nullptr) {
-      throw DecodingError("Unable to decode symbol.");
-    }
+  auto entry{ table_.lookup(bit_reader_.peek_bits(DecodingTable::MAX_CODE_LENGTH)) };
 
-    if (current->left == nullptr && current->right == nullptr) {
-      return current->symbol.value();
-    }
-
-    bool bit{ bit_reader_.get_single_bit() };
-    if (bit_reader_.eof()) {
-      throw DecodingError("Reached end of input while decoding.");
-    }
-
-    if (bit) {
-      current = current->right;
-    } else {
-      current = current->left;
-    }
+  if (entry.type == DecodingTable::EntryType::INVALID) {
+    throw DecodingError("Unable to decode symbol.");
   }
-}
 
-void PrefixCodeDecoder::compute_code_table()
-{
-  code_table_ = compute_canonical_code_table(code_length_table_);
-}
-
-void PrefixCodeDecoder::build_tree()
-{
-  for (auto [symbol, code] : code_table_) {
-    insert_symbol(symbol, code);
+  bit_reader_.consume_bits(entry.length);
+  if (bit_reader_.eof()) {
+    throw DecodingError("Reached end of input while decoding.");
   }
+
+  return entry.value;
 }
 
-void PrefixCodeDecoder::insert_symbol(unsigned int symbol, unsigned int code)
+unsigned int PrefixCodeDecoder::decode_symbols(SymbolBuffer &symbols)
 {
-  if (tree_root_ == nullptr) {
-    tree_root_ = std::make_shared<Node>(symbol);
-  }
+  if (multi_table_ != nullptr) {
+    const auto &entry{ multi_table_->lookup(bit_reader_.peek_bits(MultiLiteralTable::LOOKUP_BITS)) };
 
-  NodePtr current{ tree_root_ };
-  unsigned int length{ code_length_table_.at(symbol) };
-
-  for (int bit = length - 1; bit >= 0; bit--) {
-    unsigned int mask{ 1U << bit };
-    if (code & mask) {
-      if (current->right == nullptr) {
-        current->right = std::make_shared<Node>();
+    if (entry.count > 0) {
+      bit_reader_.consume_bits(entry.length);
+      if (bit_reader_.eof()) {
+        throw DecodingError("Reached end of input while decoding.");
       }
-      current = current->right;
-    } else {
-      if (current->left == nullptr) {
-        current->left = std::make_shared<Node>();
+
+      for (unsigned int i{ 0 }; i < entry.count; i++) {
+        symbols[i] = entry.literals[i];
       }
-      current = current->left;
+      return entry.count;
     }
   }
 
-  current->symbol = symbol;
+  symbols[0] = decode_symbol();
+  return 1;
 }
 
 }  // namespace prefix_codes
@@ -4,13 +4,13 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
-#include <map>
-#include <memory>
-#include <optional>
 
 namespace prefix_codes {
 
-PrefixCodeEncoder::PrefixCodeEncoder(unsigned int max_code_length) : max_code_length_{ max_code_length } {}
+PrefixCodeEncoder::PrefixCodeEncoder(unsigned int max_code_length) : max_code_length_{ max_code_length }
+{
+  assert(max_code_length_ >= 1 && max_code_length_ <= MAX_CODE_LENGTH && "max code length is out of range");
+}
 
 void PrefixCodeEncoder::encode(const FrequencyTable &frequencies)
 {
@@ -20,100 +20,87 @@ void PrefixCodeEncoder::encode(const FrequencyTable &frequencies)
 
 void PrefixCodeEncoder::compute_code_length_table(const FrequencyTable &frequencies)
 {
-  if (frequencies.size() == 0) {
-    // Block type 2 seems to insist on having at least 1 distance code, so we put a dummy code here.
-    code_length_table_ = { { 0, 0 } };
-    return;
+  code_length_table_.fill(0);
+
+  unsigned int num_symbols{ 0 };
+  for (unsigned int symbol{ 0 }; symbol < frequencies.size(); symbol++) {
+    if (frequencies[symbol] > 0) {
+      sorted_symbols_[num_symbols++] = static_cast<uint16_t>(symbol);
+    }
   }
 
-  if (frequencies.size() == 1) {
-    code_length_table_ = { { frequencies.begin()->first, 1 } };
+  if (num_symbols == 0) {
     return;
   }
 
-  assert(max_code_length_ >= std::ceil(std::log2(frequencies.size())) && "max code length is too small");
-
-  PackageList singletons{};
-  for (auto [symbol, freq] : frequencies) {
-    singletons.push_back(std::make_shared<PackageNode>(symbol, freq));
+  if (num_symbols == 1) {
+    code_length_table_[sorted_symbols_[0]] = 1;
+    return;
   }
 
-  auto compare = [](const auto &lhs, const auto &rhs) { return lhs->weight < rhs->weight; };
+  assert(max_code_length_ >= std::ceil(std::log2(num_symbols)) && "max code length is too small");
 
-  std::sort(singletons.begin(), singletons.end(), compare);
+  // Ties are broken by symbol so that the code doesn't depend on the sort implementation.
+  std::sort(sorted_symbols_.begin(), sorted_symbols_.begin() + num_symbols, [&](auto lhs, auto rhs) {
+    return frequencies[lhs] < frequencies[rhs] || (frequencies[lhs] == frequencies[rhs] && lhs < rhs);
+  });
 
-  PackageList packages{ singletons };
-  for (unsigned int i{ 0 }; i < max_code_length_ - 1; i++) {
-    packages = merge(package(packages), singletons);
-  }
+  // The first list is just the symbols. Every later list merges the symbols with packages made from adjacent pairs of
+  // the previous list, taking symbols first when weights are equal. Only the weights of the previous list are needed to
+  // build the next one, but which items were packages has to be remembered for every level.
+  std::array<unsigned int, MAX_CODE_LENGTH> list_sizes{};
 
-  for (unsigned int i{ 0 }; i < 2 * frequencies.size() - 2; i++) {
-    expand_package(packages[i]);
+  for (unsigned int i{ 0 }; i < num_symbols; i++) {
+    weights_[0][i] = frequencies[sorted_symbols_[i]];
+    is_package_[0][i] = false;
   }
-}
-
-void PrefixCodeEncoder::compute_code_table()
-{
-  code_table_ = compute_canonical_code_table(code_length_table_);
-}
-
-void PrefixCodeEncoder::expand_package(PackageNodePtr package)
-{
-  if (package->left == nullptr && package->right == nullptr) {
-    assert(package->symbol.has_value() && "package has leaf node with no symbol");
-
-    auto symbol{ package->symbol.value() };
-    if (!code_length_table_.contains(symbol)) {
-      code_length_table_.insert({ symbol, 0 });
+  list_sizes[0] = num_symbols;
+
+  for (unsigned int level{ 1 }; level < max_code_length_; level++) {
+    const auto &previous_weights{ weights_[(level - 1) % 2] };
+    auto &weights{ weights_[level % 2] };
+    auto num_packages{ list_sizes[level - 1] / 2 };
+
+    unsigned int package{ 0 }, symbol{ 0 }, size{ 0 };
+    while (package < num_packages || symbol < num_symbols) {
+      uint64_t package_weight{ 0 };
+      if (package < num_packages) {
+        package_weight = previous_weights[2 * package] + previous_weights[2 * package + 1];
+      }
+
+      if (symbol == num_symbols || (package < num_packages && package_weight < frequencies[sorted_symbols_[symbol]])) {
+        weights[size] = package_weight;
+        is_package_[level][size++] = true;
+        package++;
+      } else {
+        weights[size] = frequencies[sorted_symbols_[symbol++]];
+        is_package_[level][size++] = false;
+      }
     }
-    code_length_table_.at(symbol)++;
-    return;
+    list_sizes[level] = size;
   }
 
-  if (package->left != nullptr) {
-    expand_package(package->left);
-  }
-
-  if (package->right != nullptr) {
-    expand_package(package->right);
-  }
-}
+  // The optimal code takes the first `2 * num_symbols - 2` items of the last list. Working back down the levels, the
+  // packages among the items taken expand to twice as many items from the level below. The symbols taken at each level
+  // are always the least frequent ones, and each level a symbol is taken at adds one to its code length.
+  unsigned int num_taken{ 2 * num_symbols - 2 };
+  for (auto level{ max_code_length_ }; level-- > 0;) {
+    unsigned int num_packages_taken{ 0 };
+    for (unsigned int i{ 0 }; i < num_taken; i++) {
+      num_packages_taken += is_package_[level][i];
+    }
 
-PrefixCodeEncoder::PackageList PrefixCodeEncoder::package(const PackageList &list)
-{
-  PackageList result{};
+    for (unsigned int i{ 0 }; i < num_taken - num_packages_taken; i++) {
+      code_length_table_[sorted_symbols_[i]]++;
+    }
 
-  for (unsigned int i{ 0 }; i < list.size() / 2; i++) {
-    auto left{ list[2 * i] };
-    auto right{ list[2 * i + 1] };
-    result.push_back(std::make_shared<PackageNode>(std::nullopt, left->weight + right->weight, left, right));
+    num_taken = 2 * num_packages_taken;
   }
-
-  return result;
 }
 
-PrefixCodeEncoder::PackageList PrefixCodeEncoder::merge(const PackageList &list1, const PackageList &list2)
+void PrefixCodeEncoder::compute_code_table()
 {
-  PackageList result{};
-  unsigned int i{ 0 }, j{ 0 };
-
-  while (i < list1.size() && j < list2.size()) {
-    if (list1[i]->weight < list2[j]->weight) {
-      result.push_back(list1[i++]);
-    } else {
-      result.push_back(list2[j++]);
-    }
-  }
-
-  while (i < list1.size()) {
-    result.push_back(list1[i++]);
-  }
-
-  while (j < list2.size()) {
-    result.push_back(list2[j++]);
-  }
-
-  return result;
+  code_table_ = compute_canonical_code_table(code_length_table_);
 }
 
 }  // namespace prefix_codes
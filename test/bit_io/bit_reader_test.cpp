@@ -86,6 +86,57 @@ TEST_CASE("get_bits()", "[bit_reader][get_bits]")
   }
 }
 
+TEST_CASE("peek_bits() and consume_bits()", "[bit_reader][peek_bits][consume_bits]")
+{
+  std::istringstream iss{};
+  bit_io::BitReader bit_reader{ iss };
+
+  SECTION("Peeking doesn't consume bits")
+  {
+    set_stream_bytes(iss, { 0b10101110 });
+    REQUIRE(bit_reader.peek_bits(4) == 0b1110);
+    REQUIRE(bit_reader.peek_bits(8) == 0b10101110);
+  }
+
+  SECTION("Consuming advances past peeked bits")
+  {
+    set_stream_bytes(iss, { 0b10101110, 0b00000001 });
+    bit_reader.consume_bits(4);
+    REQUIRE(bit_reader.peek_bits(5) == 0b11010);
+  }
+
+  SECTION("Peeking past end of stream yields zeros")
+  {
+    set_stream_bytes(iss, { 0xff });
+    REQUIRE(bit_reader.peek_bits(16) == 0xff);
+    REQUIRE(!bit_reader.eof());
+  }
+
+  SECTION("Properly handles refills across many bytes")
+  {
+    set_stream_bytes(iss, { 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef, 0x01, 0x23 });
+    bit_reader.consume_bits(4);
+    REQUIRE(bit_reader.peek_bits(56) == 0xfcdab896745230);
+    bit_reader.consume_bits(56);
+    REQUIRE(bit_reader.peek_bits(16) == 0x301e);
+  }
+}
+
+TEST_CASE("align_to_byte()", "[bit_reader][align_to_byte]")
+{
+  std::istringstream iss{};
+  bit_io::BitReader bit_reader{ iss };
+
+  set_stream_bytes(iss, { 0xff, 0b00000101 });
+
+  bit_reader.get_bits(3);
+  bit_reader.align_to_byte();
+  REQUIRE(bit_reader.get_bits(8) == 0b00000101);
+
+  bit_reader.align_to_byte();
+  REQUIRE(!bit_reader.eof());
+}
+
 TEST_CASE("eof()", "[bit_reader][eof]")
 {
   std::istringstream iss{};
@@ -113,4 +164,13 @@ TEST_CASE("eof()", "[bit_reader][eof]")
     bit_reader.get_bits(1);
     REQUIRE(bit_reader.eof());
   }
+
+  SECTION("Consuming peeked padding yields EOF")
+  {
+    set_stream_bytes(iss, { 0xff });
+
+    bit_reader.peek_bits(9);
+    bit_reader.consume_bits(9);
+    REQUIRE(bit_reader.eof());
+  }
 }
@@ -1,9 +1,13 @@
 #include "bit_io/bit_reader.hpp"
 #include "bit_io/bit_writer.hpp"
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
 
 #include <catch2/catch_test_macros.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <sstream>
+#include <vector>
 
 TEST_CASE("Can read back written bits", "[bit_writer][bit_reader]")
 {
@@ -50,3 +54,25 @@ TEST_CASE("Can read back written bits", "[bit_writer][bit_reader]")
     }
   }
 }
+
+TEST_CASE("Can read back bits written to memory", "[bit_writer][bit_reader]")
+{
+  std::vector<std::byte> buffer{};
+  bit_io::VectorByteSink sink{ buffer };
+  bit_io::BitWriter bit_writer{ sink };
+
+  for (uint64_t i{ 0 }; i < 100000; i++) {
+    bit_writer.put_bits(i, 17);
+  }
+  bit_writer.finish();
+
+  REQUIRE(buffer.size() == (100000 * 17 + 7) / 8);
+
+  bit_io::SpanByteSource source{ buffer };
+  bit_io::BitReader bit_reader{ source };
+
+  for (uint64_t i{ 0 }; i < 100000; i++) {
+    REQUIRE(bit_reader.get_bits(17) == i);
+  }
+  REQUIRE(!bit_reader.eof());
+}
@@ -0,0 +1,145 @@
+#include "bit_io/bit_counter.hpp"
+#include "bit_io/bit_writer.hpp"
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
+#include "gzip/block_encoder.hpp"
+#include "gzip/gzip_reader.hpp"
+#include "lzss/lzss_encoder.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+#include "test_inputs.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("Block sizes match the blocks written", "[block_encoder]")
+{
+  using enum gzip::BlockEncoder::BlockType;
+
+  auto input = GENERATE(as<std::string>{},
+    "",
+    "a",
+    "a lass; a lad; a salad; alaska",
+    std::string(1000, 'z'),
+    random_string(10000, 4),
+    "It was the best of times, it was the worst of times, it was the age of wisdom, it was the age of foolishness");
+  auto block_type = GENERATE(STORED, FIXED, DYNAMIC);
+  auto bit_position = GENERATE(0U, 3U, 7U);
+
+  CAPTURE(input, static_cast<unsigned int>(block_type), bit_position);
+
+  lzss::LzssEncoder lzss_encoder{};
+  lzss_encoder.encode(input);
+
+  gzip::BlockEncoder block_encoder{};
+  block_encoder.prepare(input, lzss_encoder.get_symbol_buffer());
+
+  std::vector<std::byte> output{};
+  bit_io::VectorByteSink sink{ output };
+  bit_io::BitWriter bit_writer{ sink };
+
+  // A gzip header, then a fixed block of 9-bit literals that puts the block under test at the right bit position. The
+  // output can then be read back.
+  for (unsigned int byte : { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 }) {
+    bit_writer.put_bits(byte, 8);
+  }
+
+  const unsigned int PADDING_LITERAL{ 144 };
+  auto num_padding_literals{ (bit_position + 6) % 8 };
+
+  bit_writer.put_bits(0b010, 3);
+  for (unsigned int i{ 0 }; i < num_padding_literals; i++) {
+    bit_writer.put_bits(0b110010000, 9, false);
+  }
+  bit_writer.put_bits(0, 7);
+
+  auto start{ bit_writer.get_bit_count() };
+  REQUIRE(start % 8 == bit_position);
+
+  block_encoder.write_block(bit_writer, block_type, true);
+  REQUIRE(bit_writer.get_bit_count() - start == block_encoder.get_block_size(block_type, bit_position));
+
+  bit_writer.finish();
+
+  bit_io::SpanByteSource source{ output };
+  std::vector<std::byte> decompressed{};
+  bit_io::VectorByteSink decompressed_sink{ decompressed };
+  gzip::GzipReader{ source, decompressed_sink }.read();
+
+  auto expected{ std::string(num_padding_literals, static_cast<char>(PADDING_LITERAL)) + input };
+  auto expected_bytes{ std::as_bytes(std::span{ expected }) };
+  REQUIRE(decompressed == std::vector<std::byte>{ expected_bytes.begin(), expected_bytes.end() });
+}
+
+TEST_CASE("Block sizes match a count of the bits written", "[block_encoder]")
+{
+  using enum gzip::BlockEncoder::BlockType;
+
+  // Every level, since their symbols differ, and inputs that use many codes of each kind.
+  auto level = GENERATE(range(lzss::MIN_LEVEL, lzss::MAX_LEVEL + 1));
+  auto input = GENERATE(
+    as<std::string>{}, "", random_string(10000, 256), random_string(10000, 16), std::string(5000, 'q'));
+  auto block_type = GENERATE(STORED, FIXED, DYNAMIC);
+  auto bit_position = GENERATE(0U, 5U);
+
+  CAPTURE(level, input.length(), static_cast<unsigned int>(block_type), bit_position);
+
+  lzss::LzssEncoder lzss_encoder{ lzss::get_level_config(level) };
+  auto block_input{ std::string_view{ input }.substr(0, lzss_encoder.encode(input)) };
+
+  gzip::BlockEncoder block_encoder{};
+  block_encoder.prepare(block_input, lzss_encoder.get_symbol_buffer());
+
+  bit_io::BitCounter bit_counter{ bit_position };
+  block_encoder.write_block(bit_counter, block_type, false);
+
+  REQUIRE(bit_counter.get_bit_count() - bit_position == block_encoder.get_block_size(block_type, bit_position));
+}
+
+TEST_CASE("Picks the smallest block type", "[block_encoder]")
+{
+  using enum gzip::BlockEncoder::BlockType;
+
+  auto [input, expected_type] = GENERATE(table<std::string, gzip::BlockEncoder::BlockType>({
+    { "a", FIXED },
+    { "a lass; a lad; a salad; alaska", FIXED },
+    { random_string(10000, 256), STORED },
+    { random_string(10000, 4), DYNAMIC },
+  }));
+
+  CAPTURE(input.length());
+
+  lzss::LzssEncoder lzss_encoder{};
+  lzss_encoder.encode(input);
+
+  gzip::BlockEncoder block_encoder{};
+  block_encoder.prepare(input, lzss_encoder.get_symbol_buffer());
+
+  auto block_type{ block_encoder.get_smallest_block_type() };
+  REQUIRE(block_type == expected_type);
+  for (auto other_type : { STORED, FIXED, DYNAMIC }) {
+    REQUIRE(block_encoder.get_block_size(block_type) <= block_encoder.get_block_size(other_type));
+  }
+}
+
+TEST_CASE("Blocks that can't be stored are never stored", "[block_encoder]")
+{
+  using enum gzip::BlockEncoder::BlockType;
+
+  auto input{ random_string(10000, 256) };
+
+  lzss::LzssEncoder lzss_encoder{};
+  lzss_encoder.encode(input);
+
+  gzip::BlockEncoder block_encoder{};
+  block_encoder.prepare(input, lzss_encoder.get_symbol_buffer());
+  REQUIRE(block_encoder.get_smallest_block_type() == STORED);
+
+  // Without its input, the writer's way of saying the block is too long to store.
+  block_encoder.prepare({}, lzss_encoder.get_symbol_buffer(), false);
+  REQUIRE(block_encoder.get_smallest_block_type() != STORED);
+}
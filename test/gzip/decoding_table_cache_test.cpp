@@ -0,0 +1,54 @@
+#include "gzip/decoding_table_cache.hpp"
+#include "prefix_codes/decoding_table.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Decoding table cache reuses tables for repeated code lengths", "[decoding_table_cache]")
+{
+  gzip::DecodingTableCache cache{};
+
+  prefix_codes::CodeLengthTable ll_code_lengths{ 1, 2, 2 };
+  prefix_codes::CodeLengthTable other_ll_code_lengths{ 2, 2, 1 };
+  prefix_codes::CodeLengthTable distance_code_lengths{ 1, 1 };
+
+  const auto *tables{ &cache.get_tables(ll_code_lengths, distance_code_lengths) };
+  REQUIRE(cache.get_hits() == 0);
+  REQUIRE(cache.get_misses() == 1);
+
+  SECTION("Same code lengths hit")
+  {
+    REQUIRE(&cache.get_tables(ll_code_lengths, distance_code_lengths) == tables);
+    REQUIRE(cache.get_hits() == 1);
+    REQUIRE(cache.get_misses() == 1);
+  }
+
+  SECTION("Different code lengths miss and get their own tables")
+  {
+    const auto &other_tables{ cache.get_tables(other_ll_code_lengths, distance_code_lengths) };
+    REQUIRE(cache.get_misses() == 2);
+    REQUIRE(other_tables.ll_table.lookup(0b0).value == 2);
+
+    REQUIRE(cache.get_tables(ll_code_lengths, distance_code_lengths).ll_table.lookup(0b0).value == 0);
+    REQUIRE(cache.get_hits() == 1);
+  }
+
+  SECTION("Least recently used tables are evicted")
+  {
+    for (unsigned int length{ 1 }; length <= 8; length++) {
+      cache.get_tables(ll_code_lengths, prefix_codes::CodeLengthTable{ length });
+    }
+    REQUIRE(cache.get_misses() == 9);
+
+    cache.get_tables(ll_code_lengths, distance_code_lengths);
+    REQUIRE(cache.get_misses() == 10);
+  }
+
+  SECTION("Invalid code lengths are not cached")
+  {
+    prefix_codes::CodeLengthTable invalid_code_lengths{ 1, 1, 1 };
+    REQUIRE_THROWS_AS(cache.get_tables(invalid_code_lengths, distance_code_lengths), prefix_codes::DecodingError);
+    REQUIRE_THROWS_AS(cache.get_tables(invalid_code_lengths, distance_code_lengths), prefix_codes::DecodingError);
+    REQUIRE(cache.get_hits() == 0);
+  }
+}
@@ -0,0 +1,54 @@
+#include "gzip/emission_table.hpp"
+#include "gzip/fixed_code_tables.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <tuple>
+
+TEST_CASE("Fixed emission table holds reversed codes with extra bits attached", "[emission_table]")
+{
+  const auto &emission_table{ gzip::fixed_code_tables::EMISSION_TABLE };
+
+  SECTION("Length/literal codes")
+  {
+    // clang-format off
+    auto [code, bits, num_bits] = GENERATE(
+      std::make_tuple(97U, 0b10001001U, 8U),
+      std::make_tuple(255U, 0b111111111U, 9U),
+      std::make_tuple(256U, 0b0000000U, 7U)
+    );
+    // clang-format on
+
+    CAPTURE(code);
+
+    auto entry{ emission_table.get_ll_entry(code) };
+    REQUIRE(entry.bits == bits);
+    REQUIRE(entry.num_bits == num_bits);
+  }
+
+  SECTION("Lengths")
+  {
+    // clang-format off
+    auto [length, bits, num_bits] = GENERATE(
+      std::make_tuple(3U, 0b1000000U, 7U),
+      std::make_tuple(11U, 0b01001000U, 8U),
+      std::make_tuple(12U, 0b11001000U, 8U),
+      std::make_tuple(257U, 0b1111000100011U, 13U),
+      std::make_tuple(258U, 0b10100011U, 8U)
+    );
+    // clang-format on
+
+    CAPTURE(length);
+
+    auto entry{ emission_table.get_length_entry(length) };
+    REQUIRE(entry.bits == bits);
+    REQUIRE(entry.num_bits == num_bits);
+  }
+
+  SECTION("Distance codes")
+  {
+    auto entry{ emission_table.get_distance_entry(4) };
+    REQUIRE(entry.bits == 0b00100);
+    REQUIRE(entry.num_bits == 5);
+  }
+}
@@ -0,0 +1,330 @@
+#include "bit_io/bit_writer.hpp"
+#include "bit_io/byte_sink.hpp"
+#include "bit_io/byte_source.hpp"
+#include "gzip/block_encoder.hpp"
+#include "gzip/gzip_reader.hpp"
+#include "gzip/gzip_writer.hpp"
+#include "gzip/stream_format.hpp"
+#include "lzss/lzss_dictionary_builder.hpp"
+#include "lzss/lzss_encoder_config.hpp"
+#include "lzss/lzss_symbol.hpp"
+#include "test_inputs.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+std::vector<std::byte> to_bytes(const std::string &string)
+{
+  auto bytes{ std::as_bytes(std::span{ string }) };
+  return { bytes.begin(), bytes.end() };
+}
+
+std::vector<std::byte> compress(const std::vector<std::byte> &input, unsigned int level = lzss::DEFAULT_LEVEL)
+{
+  bit_io::SpanByteSource source{ input };
+  std::vector<std::byte> output{};
+  bit_io::VectorByteSink sink{ output };
+
+  gzip::GzipWriter{ source, sink, lzss::get_level_config(level) }.write();
+  return output;
+}
+
+std::vector<std::byte> decompress(const std::vector<std::byte> &input)
+{
+  bit_io::SpanByteSource source{ input };
+  std::vector<std::byte> output{};
+  bit_io::VectorByteSink sink{ output };
+
+  gzip::GzipReader{ source, sink }.read();
+  return output;
+}
+
+std::string repeat(const std::string &string, unsigned int count)
+{
+  std::string result{};
+  for (unsigned int i{ 0 }; i < count; i++) {
+    result += string;
+  }
+  return result;
+}
+
+std::string random_words(unsigned int count)
+{
+  const std::vector<std::string> WORDS{ "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "and", "then",
+    "runs", "away", "from", "farmer", "who", "owns", "it" };
+
+  std::mt19937 generator{ count };
+  std::uniform_int_distribution<std::size_t> distribution{ 0, WORDS.size() - 1 };
+
+  std::string result{};
+  for (unsigned int i{ 0 }; i < count; i++) {
+    result += WORDS[distribution(generator)] + " ";
+  }
+  return result;
+}
+
+TEST_CASE("Decompressing compressed input recovers the input", "[gzip]")
+{
+  auto input = GENERATE(as<std::string>{},
+    "",
+    "a",
+    "banana",
+    "a lass; a lad; a salad; alaska",
+    repeat("abcdefgh", 20000),
+    repeat(std::string(1, '\0'), 100000),
+    random_string(200000, 256),
+    random_string(200000, 4),
+    random_string(100000, 256) + repeat("abcdefgh", 10000) + random_string(100000, 256));
+
+  CAPTURE(input.length());
+
+  auto bytes{ to_bytes(input) };
+  REQUIRE(decompress(compress(bytes)) == bytes);
+}
+
+TEST_CASE("Every compression level round trips", "[gzip]")
+{
+  auto level = GENERATE(range(lzss::MIN_LEVEL, lzss::MAX_LEVEL + 1));
+  auto input = GENERATE(as<std::string>{}, repeat("abcdefgh", 20000), random_string(200000, 4), random_words(50000));
+
+  CAPTURE(level, input.length());
+
+  auto bytes{ to_bytes(input) };
+  REQUIRE(decompress(compress(bytes, level)) == bytes);
+}
+
+TEST_CASE("Every strategy round trips", "[gzip]")
+{
+  auto strategy = GENERATE(lzss::Strategy::RLE, lzss::Strategy::HUFFMAN_ONLY);
+  auto input = GENERATE(as<std::string>{}, "", std::string(100000, 'a'), random_string(200000, 4), random_words(50000));
+
+  CAPTURE(static_cast<int>(strategy), input.length());
+
+  auto config{ lzss::get_level_config(lzss::DEFAULT_LEVEL) };
+  config.strategy = strategy;
+
+  auto bytes{ to_bytes(input) };
+  bit_io::SpanByteSource source{ bytes };
+  std::vector<std::byte> output{};
+  bit_io::VectorByteSink sink{ output };
+  gzip::GzipWriter{ source, sink, config }.write();
+
+  REQUIRE(decompress(output) == bytes);
+}
+
+TEST_CASE("Higher compression levels give smaller output", "[gzip]")
+{
+  auto bytes{ to_bytes(random_words(50000)) };
+
+  auto fastest_size{ compress(bytes, lzss::MIN_LEVEL).size() };
+  auto default_size{ compress(bytes, lzss::DEFAULT_LEVEL).size() };
+  auto best_size{ compress(bytes, lzss::OPTIMAL_PARSE_LEVEL - 1).size() };
+  auto optimal_size{ compress(bytes, lzss::OPTIMAL_PARSE_LEVEL).size() };
+
+  REQUIRE(default_size < fastest_size);
+  REQUIRE(best_size <= default_size);
+  REQUIRE(optimal_size < best_size);
+}
+
+TEST_CASE("Input that doesn't compress barely grows", "[gzip]")
+{
+  auto level = GENERATE(lzss::MIN_LEVEL, lzss::DEFAULT_LEVEL, lzss::OPTIMAL_PARSE_LEVEL);
+  CAPTURE(level);
+
+  // Each stored block adds 5 bytes, and consecutive ones are merged up to the most a stored block can hold. Then the
+  // gzip header and footer.
+  auto bytes{ to_bytes(random_string(200000, 256)) };
+  REQUIRE(compress(bytes, level).size()
+          <= bytes.size() + 5 * (bytes.size() / gzip::BlockEncoder::MAX_STORED_BLOCK_LENGTH + 1) + 18);
+}
+
+TEST_CASE("Compresses into a caller-provided buffer", "[gzip]")
+{
+  auto input{ to_bytes(repeat("hello, world! ", 1000)) };
+
+  bit_io::SpanByteSource source{ input };
+
+  SECTION("Output fits in the buffer")
+  {
+    std::vector<std::byte> buffer(input.size());
+    bit_io::SpanByteSink sink{ buffer };
+
+    gzip::GzipWriter{ source, sink }.write();
+
+    buffer.resize(sink.size());
+    REQUIRE(decompress(buffer) == input);
+  }
+
+  SECTION("Output overflowing the buffer throws")
+  {
+    std::vector<std::byte> buffer(16);
+    bit_io::SpanByteSink sink{ buffer };
+
+    REQUIRE_THROWS_AS(gzip::GzipWriter(source, sink).write(), bit_io::ByteSinkError);
+  }
+}
+
+TEST_CASE("Decompresses stored and fixed code blocks", "[gzip]")
+{
+  // Produced by zlib at levels 0 and 9, which give a stored block and a fixed code block for input this short.
+  // clang-format off
+  auto compressed = GENERATE(
+    std::vector<unsigned char>{
+      0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x03, 0x01, 0x18, 0x00, 0xe7, 0xff, 0x68, 0x65, 0x6c, 0x6c,
+      0x6f, 0x20, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x68, 0x65, 0x6c, 0x6c, 0x6f,
+      0x21, 0x40, 0x71, 0xe5, 0xa7, 0x18, 0x00, 0x00, 0x00
+    },
+    std::vector<unsigned char>{
+      0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x57, 0xc8, 0x40, 0x27,
+      0x15, 0x01, 0x40, 0x71, 0xe5, 0xa7, 0x18, 0x00, 0x00, 0x00
+    }
+  );
+  // clang-format on
+
+  auto bytes{ std::as_bytes(std::span{ compressed }) };
+  REQUIRE(decompress({ bytes.begin(), bytes.end() }) == to_bytes("hello hello hello hello!"));
+}
+
+TEST_CASE("Rejects codes that never appear in valid data", "[gzip]")
+{
+  // A fixed code block with the literal 'a', then either a bad length/literal code, or length code 257 followed by a
+  // bad distance code. Fixed codes are written most significant bit first.
+  auto [ll_code_bits, distance_code_bits] = GENERATE(table<unsigned int, int>({
+    { 0b11000110, -1 },  // Length/literal code 286.
+    { 0b11000111, -1 },  // Length/literal code 287.
+    { 0b0000001, 0b11110 },  // Length code 257, distance code 30.
+    { 0b0000001, 0b11111 },  // Length code 257, distance code 31.
+  }));
+
+  CAPTURE(ll_code_bits, distance_code_bits);
+
+  std::vector<std::byte> compressed{};
+  bit_io::VectorByteSink sink{ compressed };
+  bit_io::BitWriter bit_writer{ sink };
+
+  for (unsigned int byte : { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 }) {
+    bit_writer.put_bits(byte, 8);
+  }
+  bit_writer.put_bits(0b011, 3);
+  bit_writer.put_bits(0x30 + 'a', 8, false);
+  bit_writer.put_bits(ll_code_bits, distance_code_bits < 0 ? 8 : 7, false);
+  if (distance_code_bits >= 0) {
+    bit_writer.put_bits(static_cast<unsigned int>(distance_code_bits), 5, false);
+  }
+  bit_writer.put_bits(0, 32);
+  bit_writer.finish();
+
+  REQUIRE_THROWS_AS(decompress(compressed), gzip::GzipReaderError);
+}
+
+TEST_CASE("Reuses decoding tables for blocks with the same code lengths", "[gzip]")
+{
+  // Without matches, every block is a full symbol buffer of literals. A line that divides the buffer evenly gives each
+  // block the same symbol frequencies, and so the same code lengths.
+  std::string line{ "2026-10-18 INFO request ok 2000\n" };
+  REQUIRE(lzss::LzssSymbolBuffer::CAPACITY % line.length() == 0);
+  auto input{ to_bytes(repeat(line, 20000)) };
+
+  auto config{ lzss::get_level_config(lzss::DEFAULT_LEVEL) };
+  config.strategy = lzss::Strategy::HUFFMAN_ONLY;
+
+  bit_io::SpanByteSource input_source{ input };
+  std::vector<std::byte> compressed{};
+  bit_io::VectorByteSink compressed_sink{ compressed };
+  gzip::GzipWriter{ input_source, compressed_sink, config }.write();
+
+  bit_io::SpanByteSource source{ compressed };
+  std::vector<std::byte> output{};
+  bit_io::VectorByteSink sink{ output };
+
+  gzip::GzipReader reader{ source, sink };
+  reader.read();
+
+  REQUIRE(output == input);
+  REQUIRE(reader.get_decoding_table_cache().get_hits() > 0);
+}
+
+TEST_CASE("Preset dictionaries", "[gzip]")
+{
+  // Records that share most of their strings with each other, but hardly repeat anything within themselves.
+  auto make_record = [](unsigned int i) {
+    return "{\"id\": " + std::to_string(i * 7919) + ", \"status\": \"delivered\", \"warehouse\": \"north-east\", "
+           + "\"carrier\": \"express\", \"weight_kg\": " + std::to_string(i % 40) + "}";
+  };
+
+  std::vector<std::string> samples{};
+  for (unsigned int i{ 0 }; i < 200; i++) {
+    samples.push_back(make_record(i));
+  }
+
+  auto dictionary_string{ lzss::build_dictionary(samples, 1024) };
+  REQUIRE(!dictionary_string.empty());
+  REQUIRE(dictionary_string.length() <= 1024);
+  REQUIRE(dictionary_string.find("warehouse") != std::string::npos);
+
+  auto dictionary{ to_bytes(dictionary_string) };
+  auto record{ to_bytes(make_record(1000)) };
+
+  auto compress_with = [&](gzip::StreamFormat format, const std::vector<std::byte> &dictionary) {
+    bit_io::SpanByteSource source{ record };
+    std::vector<std::byte> output{};
+    bit_io::VectorByteSink sink{ output };
+    gzip::GzipWriter{ source, sink, lzss::get_level_config(lzss::DEFAULT_LEVEL), format, dictionary }.write();
+    return output;
+  };
+
+  auto decompress_with = [](const std::vector<std::byte> &input,
+                           gzip::StreamFormat format,
+                           const std::vector<std::byte> &dictionary) {
+    bit_io::SpanByteSource source{ input };
+    std::vector<std::byte> output{};
+    bit_io::VectorByteSink sink{ output };
+    gzip::GzipReader{ source, sink, format, dictionary }.read();
+    return output;
+  };
+
+  SECTION("Round trip")
+  {
+    auto format = GENERATE(gzip::StreamFormat::ZLIB, gzip::StreamFormat::RAW);
+    CAPTURE(static_cast<int>(format));
+
+    auto compressed{ compress_with(format, dictionary) };
+    REQUIRE(decompress_with(compressed, format, dictionary) == record);
+    REQUIRE(compressed.size() < compress_with(format, {}).size() / 2);
+  }
+
+  SECTION("zlib streams say which dictionary they need")
+  {
+    auto compressed{ compress_with(gzip::StreamFormat::ZLIB, dictionary) };
+
+    REQUIRE_THROWS_AS(decompress_with(compressed, gzip::StreamFormat::ZLIB, {}), gzip::GzipReaderError);
+    REQUIRE_THROWS_AS(decompress_with(compressed, gzip::StreamFormat::ZLIB, to_bytes("something else")),
+      gzip::GzipReaderError);
+  }
+
+  SECTION("Reads zlib's own output")
+  {
+    // Python's `zlib.compressobj(zdict=b'{"name": "value"}')` on `{"name": "other value"}`.
+    // clang-format off
+    std::vector<unsigned char> compressed{
+      0x78, 0xf9, 0x31, 0xab, 0x05, 0x99, 0xab, 0x86, 0x0b, 0xe4, 0x97, 0x64, 0xa4, 0x16, 0x29, 0x40, 0x85, 0x01, 0x5b,
+      0x58, 0x07, 0xdb
+    };
+    // clang-format on
+
+    auto bytes{ std::as_bytes(std::span{ compressed }) };
+    REQUIRE(decompress_with({ bytes.begin(), bytes.end() }, gzip::StreamFormat::ZLIB, to_bytes("{\"name\": \"value\"}"))
+            == to_bytes("{\"name\": \"other value\"}"));
+  }
+
+  SECTION("gzip streams can't use one")
+  {
+    REQUIRE_THROWS_AS(compress_with(gzip::StreamFormat::GZIP, dictionary), std::invalid_argument);
+  }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <random>
+#include <string>
+
+// `length` bytes drawn evenly from the first `alphabet_size` byte values. The same arguments always give the same
+// string.
+inline std::string random_string(unsigned int length, unsigned int alphabet_size)
+{
+  std::mt19937 generator{ length };
+  std::uniform_int_distribution<unsigned int> distribution{ 0, alphabet_size - 1 };
+
+  std::string result{};
+  for (unsigned int i{ 0 }; i < length; i++) {
+    result += static_cast<char>(distribution(generator));
+  }
+  return result;
+}
@@ -0,0 +1,67 @@
+#include "lzss/lzss_block_splitter.hpp"
+#include "prefix_codes/prefix_code_types.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+
+namespace {
+
+// Adds `count` of the length/literal code `code` to the block, one at a time.
+void add(lzss::LzssBlockSplitter &block_splitter,
+  prefix_codes::FrequencyTable &ll_frequencies,
+  std::size_t &num_symbols,
+  unsigned int code,
+  unsigned int count)
+{
+  for (unsigned int i{ 0 }; i < count; i++) {
+    ll_frequencies[code]++;
+    block_splitter.update(ll_frequencies, ++num_symbols);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Doesn't end blocks while the symbols stay the same", "[block_splitter]")
+{
+  lzss::LzssBlockSplitter block_splitter{};
+  prefix_codes::FrequencyTable ll_frequencies{};
+  std::size_t num_symbols{ 0 };
+
+  for (unsigned int i{ 0 }; i < 1000; i++) {
+    add(block_splitter, ll_frequencies, num_symbols, 'a' + i % 26, 10);
+    add(block_splitter, ll_frequencies, num_symbols, 257 + i % 10, 5);
+  }
+
+  REQUIRE(!block_splitter.should_end_block());
+}
+
+TEST_CASE("Ends blocks when the symbols change", "[block_splitter]")
+{
+  lzss::LzssBlockSplitter block_splitter{};
+  prefix_codes::FrequencyTable ll_frequencies{};
+  std::size_t num_symbols{ 0 };
+
+  for (unsigned int i{ 0 }; i < 1000; i++) {
+    add(block_splitter, ll_frequencies, num_symbols, 'a' + i % 26, 10);
+  }
+  REQUIRE(!block_splitter.should_end_block());
+
+  // Long back-references look nothing like lowercase letters.
+  add(block_splitter, ll_frequencies, num_symbols, 270, 1000);
+  REQUIRE(block_splitter.should_end_block());
+
+  block_splitter.clear();
+  REQUIRE(!block_splitter.should_end_block());
+}
+
+TEST_CASE("Doesn't end blocks before the minimum length", "[block_splitter]")
+{
+  lzss::LzssBlockSplitter block_splitter{};
+  prefix_codes::FrequencyTable ll_frequencies{};
+  std::size_t num_symbols{ 0 };
+
+  add(block_splitter, ll_frequencies, num_symbols, 'a', 2000);
+  add(block_splitter, ll_frequencies, num_symbols, 0xff, 2000);
+
+  REQUIRE(!block_splitter.should_end_block());
+}
@@ -0,0 +1,48 @@
+#include "lzss/lzss_code_tables.hpp"
+#include "lzss/lzss_constants.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <tuple>
+
+TEST_CASE("Lengths and distances map to the entries covering them", "[code_tables]")
+{
+  SECTION("Every length")
+  {
+    for (auto length{ lzss::constants::MIN_BACKREF_LENGTH }; length <= lzss::constants::MAX_BACKREF_LENGTH; length++) {
+      CAPTURE(length);
+
+      const auto &entry{ lzss::code_tables::get_length_entry_by_length(length) };
+      REQUIRE(length >= entry.lower_bound);
+      REQUIRE(length <= entry.upper_bound);
+    }
+  }
+
+  SECTION("Every distance")
+  {
+    for (unsigned int distance{ 1 }; distance <= lzss::constants::MAX_BACKREF_DISTANCE; distance++) {
+      CAPTURE(distance);
+
+      const auto &entry{ lzss::code_tables::get_distance_entry_by_distance(distance) };
+      REQUIRE(distance >= entry.lower_bound);
+      REQUIRE(distance <= entry.upper_bound);
+    }
+  }
+
+  SECTION("Either side of a range boundary")
+  {
+    // clang-format off
+    auto [distance, code] = GENERATE(
+      std::make_tuple(256U, 15U),
+      std::make_tuple(257U, 16U),
+      std::make_tuple(384U, 16U),
+      std::make_tuple(385U, 17U),
+      std::make_tuple(32768U, 29U)
+    );
+    // clang-format on
+
+    CAPTURE(distance);
+
+    REQUIRE(lzss::code_tables::get_distance_entry_by_distance(distance).code == code);
+  }
+}
@@ -2,7 +2,40 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <random>
 #include <string>
+#include <string_view>
+
+namespace {
+
+// Appends the input the symbols encode to `output`, which holds the input before them.
+void decode(const lzss::LzssSymbolBuffer &symbol_buffer, std::string &output)
+{
+  for (const auto &symbol : symbol_buffer) {
+    if (symbol.is_literal()) {
+      output += static_cast<char>(symbol.get_literal());
+      continue;
+    }
+
+    REQUIRE(symbol.get_distance() <= output.length());
+    for (unsigned int i{ 0 }; i < symbol.get_length(); i++) {
+      output += output[output.length() - symbol.get_distance()];
+    }
+  }
+}
+
+// Encodes all of `input_buffer`, however many calls it takes, and returns the symbols from every call.
+std::string encode_all(lzss::LzssEncoder &encoder, std::string_view input_buffer)
+{
+  std::string result{};
+  while (!input_buffer.empty()) {
+    input_buffer.remove_prefix(encoder.encode(input_buffer));
+    result += encoder.get_symbol_buffer().to_string();
+  }
+  return result;
+}
+
+}  // namespace
 
 TEST_CASE("Correctly encodes input symbols", "[encoder]")
 {
@@ -12,7 +45,45 @@ TEST_CASE("Correctly encodes input symbols", "[encoder]")
     { "banana", "ban<3:2>" },
     { "aaaaaa", "a<5:1>" },
     { "ababab", "ab<4:2>" },
-    { "a lass; a lad; a salad; alaska", "a lass; <4:8>d<4:7>sala<4:9><3:23>ka" },
+    { "a lass; a lad; a salad; alaska", "a lass; <4:8>d<4:7>sa<6:9><3:23>ka" },
+  }));
+
+  CAPTURE(input_buffer);
+
+  lzss::LzssEncoder encoder{};
+  encoder.encode(input_buffer);
+
+  const auto &symbol_buffer{ encoder.get_symbol_buffer() };
+
+  REQUIRE(symbol_buffer.to_string() == expected_output);
+}
+
+TEST_CASE("Counts code frequencies as symbols are added", "[encoder]")
+{
+  lzss::LzssEncoder encoder{};
+  encoder.encode("banana");
+  REQUIRE(encoder.get_symbol_buffer().to_string() == "ban<3:2>");
+
+  const auto &ll_frequencies{ encoder.get_symbol_buffer().get_ll_frequencies() };
+  const auto &distance_frequencies{ encoder.get_symbol_buffer().get_distance_frequencies() };
+
+  REQUIRE(ll_frequencies['a'] == 1);
+  REQUIRE(ll_frequencies['b'] == 1);
+  REQUIRE(ll_frequencies['n'] == 1);
+  REQUIRE(ll_frequencies[257] == 1);
+  REQUIRE(distance_frequencies[1] == 1);
+
+  encoder.encode("x");
+  REQUIRE(encoder.get_symbol_buffer().get_ll_frequencies()['a'] == 0);
+  REQUIRE(encoder.get_symbol_buffer().get_ll_frequencies()['x'] == 1);
+}
+
+TEST_CASE("Prefers the longest match, then the closest", "[encoder]")
+{
+  auto [input_buffer, expected_output] = GENERATE(table<std::string, std::string>({
+    { "abcdXabcYabcdZ", "abcdX<3:5>Y<4:9>Z" },
+    { "abcXabcYabcZ", "abcX<3:4>Y<3:4>Z" },
+    { "abcdefXabcdeYabcdefZ", "abcdefX<5:7>Y<6:13>Z" },
   }));
 
   CAPTURE(input_buffer);
@@ -20,7 +91,229 @@ TEST_CASE("Correctly encodes input symbols", "[encoder]")
   lzss::LzssEncoder encoder{};
   encoder.encode(input_buffer);
 
-  auto symbol_list{ encoder.get_symbol_list() };
+  REQUIRE(encoder.get_symbol_buffer().to_string() == expected_output);
+}
+
+TEST_CASE("Defers a match when the next position has a longer one", "[encoder]")
+{
+  const std::string input_buffer{ "abcXbcdeYabcdeZ" };
+
+  SECTION("Lazy matching")
+  {
+    lzss::LzssEncoder encoder{};
+    encoder.encode(input_buffer);
+    REQUIRE(encoder.get_symbol_buffer().to_string() == "abcXbcdeYa<4:6>Z");
+  }
+
+  SECTION("Greedy matching")
+  {
+    lzss::LzssEncoder encoder{ lzss::get_level_config(3) };
+    encoder.encode(input_buffer);
+    REQUIRE(encoder.get_symbol_buffer().to_string() == "abcXbcdeY<3:9>deZ");
+  }
+}
+
+TEST_CASE("The fastest level only checks the most recent match", "[encoder]")
+{
+  lzss::LzssEncoder encoder{ lzss::get_level_config(lzss::MIN_LEVEL) };
+  encoder.encode("abcdefXabcdYabcdefZ");
+  REQUIRE(encoder.get_symbol_buffer().to_string() == "abcdefX<4:7>Y<4:5>efZ");
+}
+
+TEST_CASE("Other strategies", "[encoder]")
+{
+  auto config{ lzss::get_level_config(lzss::DEFAULT_LEVEL) };
+
+  SECTION("Run-length encoding")
+  {
+    config.strategy = lzss::Strategy::RLE;
+    lzss::LzssEncoder encoder{ config };
+    encoder.encode("aaaaaaXbbbbYabcabcZZ");
+    REQUIRE(encoder.get_symbol_buffer().to_string() == "a<5:1>Xb<3:1>YabcabcZZ");
+  }
+
+  SECTION("Runs carry on from one call to the next")
+  {
+    config.strategy = lzss::Strategy::RLE;
+    lzss::LzssEncoder encoder{ config };
+    encoder.encode("Xaa");
+    encoder.encode("aaaY", false);
+    REQUIRE(encoder.get_symbol_buffer().to_string() == "Xaa<3:1>Y");
+  }
+
+  SECTION("Runs carry on from the dictionary")
+  {
+    config.strategy = lzss::Strategy::RLE;
+    lzss::LzssEncoder encoder{ config };
+    encoder.set_dictionary("Xa");
+    encoder.encode("aaaY");
+    REQUIRE(encoder.get_symbol_buffer().to_string() == "<3:1>Y");
+  }
+
+  SECTION("Huffman only")
+  {
+    config.strategy = lzss::Strategy::HUFFMAN_ONLY;
+    lzss::LzssEncoder encoder{ config };
+    encoder.encode("aaaaaaXbbbbYabcabcZZ");
+    REQUIRE(encoder.get_symbol_buffer().to_string() == "aaaaaaXbbbbYabcabcZZ");
+  }
+}
+
+TEST_CASE("Optimal parsing reproduces the input", "[encoder]")
+{
+  auto input_buffer = GENERATE(as<std::string>{},
+    "",
+    "banana",
+    "a lass; a lad; a salad; alaska",
+    "abcXbcdeYabcdeZ",
+    std::string(1000, 'a') + "b" + std::string(1000, 'a'));
+
+  CAPTURE(input_buffer);
+
+  lzss::LzssEncoder encoder{ lzss::get_level_config(lzss::OPTIMAL_PARSE_LEVEL) };
+  encoder.encode(input_buffer);
+
+  std::string output{};
+  decode(encoder.get_symbol_buffer(), output);
+
+  REQUIRE(output == input_buffer);
+}
+
+TEST_CASE("Binary trees find the same matches as hash chains", "[encoder]")
+{
+  auto [length, alphabet_size] = GENERATE(table<unsigned int, unsigned int>({
+    { 1000, 2 },
+    { 20000, 4 },
+    { 100000, 26 },
+  }));
+
+  std::mt19937 generator{ length };
+  std::uniform_int_distribution<unsigned int> distribution{ 0, alphabet_size - 1 };
+
+  std::string input_buffer{};
+  for (unsigned int i{ 0 }; i < length; i++) {
+    input_buffer += static_cast<char>('a' + distribution(generator));
+  }
+
+  CAPTURE(length, alphabet_size);
+
+  // With searches that are never cut short, both find the longest and closest match at each position.
+  lzss::LzssEncoderConfig config{ 100000, 258, 258, 258, 258, 0, lzss::MatchFinderType::HASH_CHAIN };
+  lzss::LzssEncoder hash_chain_encoder{ config };
+  config.match_finder_type = lzss::MatchFinderType::BINARY_TREE;
+  lzss::LzssEncoder binary_tree_encoder{ config };
+
+  REQUIRE(encode_all(binary_tree_encoder, input_buffer) == encode_all(hash_chain_encoder, input_buffer));
+}
+
+TEST_CASE("Finds matches in earlier input buffers", "[encoder]")
+{
+  lzss::LzssEncoder encoder{};
+
+  encoder.encode("the quick brown fox");
+  REQUIRE(encoder.get_symbol_buffer().to_string() == "the quick brown fox");
+
+  encoder.encode("brown fox, the quick one");
+  REQUIRE(encoder.get_symbol_buffer().to_string() == "<9:9>, <10:30>one");
+}
+
+TEST_CASE("Finds matches in a preset dictionary", "[encoder]")
+{
+  auto level = GENERATE(range(lzss::MIN_LEVEL, lzss::MAX_LEVEL + 1));
+  CAPTURE(level);
+
+  lzss::LzssEncoder encoder{ lzss::get_level_config(level) };
+  encoder.set_dictionary("the quick brown fox");
+
+  encoder.encode("brown fox, the quick one");
+  REQUIRE(encoder.get_symbol_buffer().to_string() == "<9:9>, <10:30>one");
+}
+
+TEST_CASE("Matches don't reach past the window", "[encoder]")
+{
+  lzss::LzssEncoder encoder{};
+
+  std::string filler{};
+  for (unsigned int i{ 0 }; filler.length() < lzss::LzssWindow::MAX_DISTANCE; i++) {
+    filler += std::to_string(i * 7919) + " ";
+  }
+
+  encoder.encode("abcdefghijklmnopqrstuvwxyz");
+  encode_all(encoder, filler);
+  encoder.encode("abcdefghijklmnopqrstuvwxyz");
+
+  REQUIRE(encoder.get_symbol_buffer().to_string() == "abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST_CASE("Stops when the symbol buffer is full", "[encoder]")
+{
+  auto level = GENERATE(lzss::MIN_LEVEL, lzss::DEFAULT_LEVEL, lzss::OPTIMAL_PARSE_LEVEL);
+
+  // Mostly literals, with enough matches to exercise lazy matching across calls.
+  std::mt19937 generator{ 1 };
+  std::string input_buffer{};
+  while (input_buffer.length() < 3 * lzss::LzssSymbolBuffer::CAPACITY) {
+    input_buffer += generator() % 8 == 0 ? "abcdefgh" : std::string(1, static_cast<char>(generator()));
+  }
+
+  CAPTURE(level);
+
+  lzss::LzssEncoder encoder{ lzss::get_level_config(level) };
+  std::string output{};
+  std::string_view remaining_input{ input_buffer };
+  unsigned int num_calls{ 0 };
+
+  while (!remaining_input.empty()) {
+    auto num_bytes{ encoder.encode(remaining_input) };
+    num_calls++;
+    REQUIRE(num_bytes > 0);
+
+    decode(encoder.get_symbol_buffer(), output);
+    REQUIRE(output.length() == input_buffer.length() - remaining_input.length() + num_bytes);
+
+    remaining_input.remove_prefix(num_bytes);
+  }
+
+  // Far more literals than fit in the buffer at once.
+  REQUIRE(num_calls >= 2);
+  REQUIRE(output == input_buffer);
+}
+
+TEST_CASE("Ends the block where the input changes character", "[encoder]")
+{
+  auto level = GENERATE(lzss::MIN_LEVEL, lzss::DEFAULT_LEVEL, lzss::OPTIMAL_PARSE_LEVEL);
+  CAPTURE(level);
+
+  // Bytes from a small alphabet, which are mostly matches, then high bytes, which are all literals. Neither half has
+  // enough symbols to fill the buffer on its own.
+  std::mt19937 generator{ 1 };
+  std::string input_buffer{};
+  for (unsigned int i{ 0 }; i < 40000; i++) {
+    input_buffer += static_cast<char>('a' + generator() % 4);
+  }
+  for (unsigned int i{ 0 }; i < 12000; i++) {
+    input_buffer += static_cast<char>(0x80 + generator() % 0x80);
+  }
+
+  lzss::LzssEncoder encoder{ lzss::get_level_config(level) };
+  auto num_bytes{ encoder.encode(input_buffer) };
+
+  REQUIRE(!encoder.get_symbol_buffer().is_full());
+  REQUIRE(encoder.get_symbol_buffer().should_end_block());
+  REQUIRE(num_bytes > 40000);
+  REQUIRE(num_bytes < 42000);
+}
+
+TEST_CASE("Blocks can carry on across calls", "[encoder]")
+{
+  std::string input_buffer(100000, 'a');
+
+  lzss::LzssEncoder encoder{};
+  REQUIRE(encoder.encode(input_buffer) == input_buffer.length());
+  REQUIRE(!encoder.get_symbol_buffer().should_end_block());
+  REQUIRE(encoder.encode(input_buffer, false) == input_buffer.length());
 
-  REQUIRE(symbol_list.to_string() == expected_output);
+  std::string output{};
+  decode(encoder.get_symbol_buffer(), output);
+  REQUIRE(output == input_buffer + input_buffer);
 }
@@ -1,5 +1,6 @@
 #include "bit_io/bit_reader.hpp"
 #include "bit_io/bit_writer.hpp"
+#include "prefix_codes/decoding_table.hpp"
 #include "prefix_codes/prefix_code_decoder.hpp"
 #include "prefix_codes/prefix_code_encoder.hpp"
 #include "prefix_codes/prefix_code_types.hpp"
@@ -10,13 +11,31 @@
 #include <string>
 #include <tuple>
 
+// Symbols with Fibonacci frequencies, which give the longest possible codes.
+std::string fibonacci_string(unsigned int num_symbols)
+{
+  std::string result{};
+  unsigned int a{ 1 }, b{ 1 };
+
+  for (unsigned int i{ 0 }; i < num_symbols; i++) {
+    result += std::string(a, static_cast<char>('A' + i));
+    b = a + b;
+    a = b - a;
+  }
+
+  return result;
+}
+
 TEST_CASE("Can decode a stream of encoded symbols", "[prefix_code_decoder]")
 {
   // clang-format off
   auto [input, max_code_length] = GENERATE(
     std::make_tuple<std::string, unsigned int>("abcccdddddeeeeeefffffffffffggggggggggggg", 4),
     std::make_tuple<std::string, unsigned int>("hello", 15),
-    std::make_tuple<std::string, unsigned int>("", 15)
+    std::make_tuple<std::string, unsigned int>("", 15),
+    std::make_tuple<std::string, unsigned int>("aaaa", 15),
+    std::make_tuple<std::string, unsigned int>(fibonacci_string(20), 15),
+    std::make_tuple<std::string, unsigned int>(fibonacci_string(20), 12)
   );
   // clang-format on
 
@@ -24,10 +43,7 @@ TEST_CASE("Can decode a stream of encoded symbols", "[prefix_code_decoder]")
 
   prefix_codes::FrequencyTable frequencies{};
   for (auto symbol : input) {
-    if (!frequencies.contains(symbol)) {
-      frequencies.insert({ symbol, 0 });
-    }
-    frequencies.at(symbol)++;
+    frequencies[symbol]++;
   }
 
   prefix_codes::PrefixCodeEncoder encoder{ max_code_length };
@@ -40,19 +56,70 @@ TEST_CASE("Can decode a stream of encoded symbols", "[prefix_code_decoder]")
   auto code_length_table{ encoder.get_code_length_table() };
 
   for (auto symbol : input) {
-    bit_writer.put_bits(code_table.at(symbol), code_length_table.at(symbol), false);
+    bit_writer.put_bits(code_table[symbol], code_length_table[symbol], false);
   }
   bit_writer.finish();
 
   std::istringstream iss{ oss.str() };
   bit_io::BitReader bit_reader{ iss };
 
-  prefix_codes::PrefixCodeDecoder decoder{ bit_reader, code_length_table };
+  prefix_codes::DecodingTable decoding_table{ code_length_table };
+
+  SECTION("Decode one symbol at a time")
+  {
+    prefix_codes::PrefixCodeDecoder decoder{ bit_reader, decoding_table };
+
+    std::string symbols{};
+    for (unsigned int i{ 0 }; i < input.length(); i++) {
+      symbols += decoder.decode_symbol();
+    }
+
+    REQUIRE(symbols == input);
+  }
+
+  SECTION("Decode runs of literals")
+  {
+    prefix_codes::MultiLiteralTable multi_literal_table{ decoding_table };
+    prefix_codes::PrefixCodeDecoder decoder{ bit_reader, decoding_table, multi_literal_table };
 
-  std::string symbols{};
-  for (unsigned int i{ 0 }; i < input.length(); i++) {
-    symbols += decoder.decode_symbol();
+    // A run can extend into the padding at the end of the stream, so the last few symbols are decoded one at a time.
+    std::string symbols{};
+    prefix_codes::PrefixCodeDecoder::SymbolBuffer buffer{};
+    while (input.length() - symbols.length() >= buffer.size()) {
+      auto num_symbols{ decoder.decode_symbols(buffer) };
+      for (unsigned int i{ 0 }; i < num_symbols; i++) {
+        symbols += buffer[i];
+      }
+    }
+    while (symbols.length() < input.length()) {
+      symbols += decoder.decode_symbol();
+    }
+
+    REQUIRE(symbols == input);
   }
+}
+
+TEST_CASE("Rejects invalid code lengths", "[prefix_code_decoder]")
+{
+  // clang-format off
+  auto code_length_table = GENERATE(
+    prefix_codes::CodeLengthTable{ 1, 1, 1 },
+    prefix_codes::CodeLengthTable{ 1, 2 },
+    prefix_codes::CodeLengthTable{ 1, 16 }
+  );
+  // clang-format on
+
+  REQUIRE_THROWS_AS(prefix_codes::DecodingTable{ code_length_table }, prefix_codes::DecodingError);
+}
+
+TEST_CASE("Builds decoding tables at compile time", "[prefix_code_decoder]")
+{
+  constexpr prefix_codes::DecodingTable decoding_table{ prefix_codes::CodeLengthTable{ 2, 1, 3, 3 } };
 
-  REQUIRE(symbols == input);
+  // Canonical codes: 1 -> 0, 0 -> 10, 2 -> 110, 3 -> 111. The table is indexed by codes read low bit first.
+  STATIC_REQUIRE(decoding_table.lookup(0b0).value == 1);
+  STATIC_REQUIRE(decoding_table.lookup(0b01).value == 0);
+  STATIC_REQUIRE(decoding_table.lookup(0b011).value == 2);
+  STATIC_REQUIRE(decoding_table.lookup(0b111).value == 3);
+  STATIC_REQUIRE(decoding_table.lookup(0b111).length == 3);
 }
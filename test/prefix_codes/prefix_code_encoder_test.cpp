@@ -1,49 +1,72 @@
 #include "prefix_codes/prefix_code_encoder.hpp"
 #include "prefix_codes/prefix_code_types.hpp"
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <initializer_list>
 #include <tuple>
+#include <utility>
 
 // XXX: Check that assertions are thrown when preconditions are invalid.
 // I don't think Catch2 supports this. Might want to try out GoogleTest instead.
 
+prefix_codes::FrequencyTable make_frequency_table(std::initializer_list<std::pair<unsigned int, unsigned int>> entries)
+{
+  prefix_codes::FrequencyTable frequencies{};
+  for (auto [symbol, freq] : entries) {
+    frequencies[symbol] = freq;
+  }
+  return frequencies;
+}
+
 TEST_CASE("Generates single code of length 1 when input has single symbol", "[prefix_code_encoder]")
 {
   // clang-format off
   auto [frequencies, max_code_length] = GENERATE(
-    std::make_tuple(prefix_codes::FrequencyTable{{'a', 1}}, 1U),
-    std::make_tuple(prefix_codes::FrequencyTable{{'a', 5}}, 1U)
+    std::make_tuple(make_frequency_table({{'a', 1}}), 1U),
+    std::make_tuple(make_frequency_table({{'a', 5}}), 1U)
   );
   // clang-format on
 
-  CAPTURE(frequencies, max_code_length);
+  CAPTURE(max_code_length);
 
   prefix_codes::PrefixCodeEncoder encoder{ max_code_length };
 
   encoder.encode(frequencies);
 
   auto code_length_table{ encoder.get_code_length_table() };
-  REQUIRE(code_length_table.size() == 1);
-  REQUIRE(code_length_table.at(frequencies.begin()->first) == 1);
+  REQUIRE(std::count_if(code_length_table.begin(), code_length_table.end(), [](auto length) { return length > 0; })
+          == 1);
+  REQUIRE(code_length_table['a'] == 1);
 
   auto code_table{ encoder.get_code_table() };
-  REQUIRE(code_table.size() == 1);
+  REQUIRE(code_table['a'] == 0);
+}
+
+TEST_CASE("Generates no codes when input is empty", "[prefix_code_encoder]")
+{
+  prefix_codes::PrefixCodeEncoder encoder{ 15 };
+
+  encoder.encode(prefix_codes::FrequencyTable{});
+
+  auto code_length_table{ encoder.get_code_length_table() };
+  REQUIRE(std::all_of(code_length_table.begin(), code_length_table.end(), [](auto length) { return length == 0; }));
 }
 
 TEST_CASE("Generates valid code lengths when input has multiple symbols", "[prefix_code_encoder]")
 {
   // clang-format off
   auto [frequencies, max_code_length] = GENERATE(
-    std::make_tuple(prefix_codes::FrequencyTable{{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}, 3U),
-    std::make_tuple(prefix_codes::FrequencyTable{{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}, 4U),
-    std::make_tuple(prefix_codes::FrequencyTable{{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}, 5U),
-    std::make_tuple(prefix_codes::FrequencyTable{{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}, 15U),
-    std::make_tuple(prefix_codes::FrequencyTable{{'a', 1}, {'b', 1}}, 1U)
+    std::make_tuple(make_frequency_table({{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}), 3U),
+    std::make_tuple(make_frequency_table({{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}), 4U),
+    std::make_tuple(make_frequency_table({{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}), 5U),
+    std::make_tuple(make_frequency_table({{'a', 1}, {'b', 1}, {'c', 3}, {'d', 5}, {'e', 6}, {'f', 11}, {'g', 13}}), 15U),
+    std::make_tuple(make_frequency_table({{'a', 1}, {'b', 1}}), 1U)
   );
   // clang-format on
 
-  CAPTURE(frequencies, max_code_length);
+  CAPTURE(max_code_length);
 
   prefix_codes::PrefixCodeEncoder encoder{ max_code_length };
 
@@ -53,19 +76,45 @@ TEST_CASE("Generates valid code lengths when input has multiple symbols", "[pref
   SECTION("Code lengths satisfy Kraft-McMillan with equality")
   {
     unsigned int kraft_sum{ 0 };
-    for (auto [symbol, length] : code_length_table) {
-      kraft_sum += (1 << (max_code_length - length));
+    for (auto length : code_length_table) {
+      if (length > 0) {
+        kraft_sum += (1 << (max_code_length - length));
+      }
     }
     REQUIRE(kraft_sum == (1U << max_code_length));
   }
 
   SECTION("Code lengths do not exceed maximum length")
   {
-    for (auto [symbol, length] : code_length_table) {
+    for (unsigned int symbol{ 0 }; symbol < code_length_table.size(); symbol++) {
       DYNAMIC_SECTION("Symbol " << symbol << " has valid length")
       {
-        REQUIRE(length <= max_code_length);
+        REQUIRE(code_length_table[symbol] <= max_code_length);
       }
     }
   }
+
+  SECTION("Only symbols that occur get codes")
+  {
+    for (unsigned int symbol{ 0 }; symbol < code_length_table.size(); symbol++) {
+      REQUIRE((code_length_table[symbol] > 0) == (frequencies[symbol] > 0));
+    }
+  }
+}
+
+TEST_CASE("Generates optimal code lengths when the maximum length isn't reached", "[prefix_code_encoder]")
+{
+  auto frequencies{ make_frequency_table(
+    { { 'a', 1 }, { 'b', 1 }, { 'c', 3 }, { 'd', 5 }, { 'e', 6 }, { 'f', 11 }, { 'g', 13 } }) };
+
+  prefix_codes::PrefixCodeEncoder encoder{ 15 };
+
+  encoder.encode(frequencies);
+  auto code_length_table{ encoder.get_code_length_table() };
+
+  unsigned int total_length{ 0 };
+  for (unsigned int symbol{ 0 }; symbol < code_length_table.size(); symbol++) {
+    total_length += frequencies[symbol] * code_length_table[symbol];
+  }
+  REQUIRE(total_length == 97);
 }